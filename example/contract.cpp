@@ -33,7 +33,7 @@ CONTRACT hello : public platon::Contract{
           info.self().push_back(one_message);
           return info.self();
       }
-      CONST std::vector<my_message> get_message(const std::string &name){
+      CONST std::vector<my_message> get_message(const std::string &name) const {
           PLATON_EMIT_EVENT0(hello_event, "get_message", "event2", 2);
           return info.self();
       }
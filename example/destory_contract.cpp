@@ -37,7 +37,7 @@ CONTRACT hello : public platon::Contract{
           return info.self();
       }
 
-      CONST std::vector<my_message> get_message(const std::string &name){
+      CONST std::vector<my_message> get_message(const std::string &name) const {
           return info.self();
       }
 
@@ -17,6 +17,7 @@
 #include <list>
 #include <map>
 #include <set>
+#include <string_view>
 #include <unordered_set>
 #include <vector>
 #include "bytes_buffer.hpp"
@@ -65,7 +66,10 @@ class RLP {
     FailIfTooSmall = 16,
     Strict = ThrowOnFail | FailIfTooBig,
     VeryStrict = ThrowOnFail | FailIfTooBig | FailIfTooSmall,
-    LaissezFaire = AllowNonCanon
+    LaissezFaire = AllowNonCanon,
+    /// Data written by this contract: the canonical encoding checks are
+    /// skipped for the node and every item read from it.
+    Trusted = 32
   };
 
   using Strictness = int;
@@ -177,7 +181,9 @@ class RLP {
       operator++();
       return ret;
     }
-    RLP operator*() const { return RLP(m_currentItem); }
+    RLP operator*() const {
+      return RLP(m_currentItem, m_trusted ? int(Trusted) : int(VeryStrict));
+    }
     bool operator==(iterator const& _cmp) const {
       return m_currentItem == _cmp.m_currentItem;
     }
@@ -189,6 +195,7 @@ class RLP {
 
     size_t m_remaining = 0;
     bytesConstRef m_currentItem;
+    bool m_trusted = false;
   };
 
   /// @brief Iterator into beginning of sub-item list (valid only if we are a
@@ -203,7 +210,9 @@ class RLP {
 
   /// Best-effort conversion operators.
   explicit operator std::string() const { return toString(); }
+  explicit operator std::string_view() const { return toStringView(); }
   explicit operator bytes() const { return toBytes(); }
+  explicit operator bytesConstRef() const { return toBytesConstRef(); }
   explicit operator uint8_t() const { return toInt<uint8_t>(); }
   explicit operator uint16_t() const { return toInt<uint16_t>(); }
   explicit operator uint32_t() const { return toInt<uint32_t>(); }
@@ -270,6 +279,13 @@ class RLP {
   }
   /// Converts to string. @throws BadCast if not a string.
   std::string toStringStrict() const { return toString(Strict); }
+  /// Converts to a view of the string payload, which borrows the RLP data.
+  /// @returns the empty view if not a string.
+  std::string_view toStringView(int _flags = LaissezFaire) const {
+    bytesConstRef ref = toBytesConstRef(_flags);
+    return std::string_view(reinterpret_cast<char const*>(ref.data()),
+                            ref.size());
+  }
 
   template <class T>
   std::vector<T> toVector(int _flags = LaissezFaire) const {
@@ -418,7 +434,10 @@ class RLP {
 
   /// Throws if is non-canonical data (i.e. single byte done in two bytes that
   /// could be done in one).
-  void requireGood() const;
+  void requireGood() const {
+    if (!m_trusted) checkGood();
+  }
+  void checkGood() const;
   /// Single-byte data payload.
   bool isSingleByte() const {
     return !isNull() && m_data[0] < c_rlpDataImmLenStart;
@@ -438,6 +457,9 @@ class RLP {
   /// to as inferred from m_data.
   size_t length() const;
 
+  /// length() without the canonical encoding checks.
+  size_t trustedLength() const;
+
   /// @returns the number of bytes into the data that the payload starts.
   size_t payloadOffset() const {
     return isSingleByte() ? 0 : (1 + lengthSize());
@@ -446,15 +468,25 @@ class RLP {
   /// @returns the number of data items.
   size_t items() const;
 
+  friend class RLPIndex;
+
   /// @returns the size encoded into the RLP in @a _data and throws if _data is
-  /// too short.
-  static size_t sizeAsEncoded(bytesConstRef _data) {
-    return RLP(_data, int(ThrowOnFail) | int(FailIfTooSmall)).actualSize();
+  /// too short, unless @a _trusted.
+  static size_t sizeAsEncoded(bytesConstRef _data, bool _trusted = false) {
+    return RLP(_data, itemStrictness(_trusted)).actualSize();
+  }
+
+  /// @returns the strictness of the items read from a list.
+  static Strictness itemStrictness(bool _trusted) {
+    return _trusted ? int(Trusted) : int(ThrowOnFail) | int(FailIfTooSmall);
   }
 
   /// Our byte data.
   bytesConstRef m_data;
 
+  /// Whether the canonical encoding checks are skipped.
+  bool m_trusted = false;
+
   /// The list-indexing cache.
   mutable size_t m_lastIndex = (size_t)-1;
   mutable size_t m_lastEnd = 0;
@@ -588,6 +620,61 @@ inline T RLP::convert(int _flags) const {
   return Converter<T>::convert(*this, _flags);
 }
 
+/**
+ * @brief Offset table over the items of an RLP list.
+ *
+ * The list is scanned once, afterwards the item count is exact and every item
+ * is reached in constant time, whatever the access order. Item data is
+ * borrowed from the list. The table drawn from an arena is built in a single
+ * scan, the one on the heap counts the items first to allocate it once.
+ */
+class RLPIndex {
+ public:
+  /// Indexes @a _list, which is empty if it is not a list.
+  explicit RLPIndex(RLP const& _list) : m_list(_list) {
+    m_offsets.reserve((_list.itemCount() + 1) * sizeof(size_t));
+    build();
+  }
+
+  /// Indexes @a _list with the table drawn from @a _arena.
+  RLPIndex(RLP const& _list, Arena& _arena)
+      : m_list(_list), m_offsets(_arena) {
+    build();
+  }
+
+  /// @returns the number of items in the list.
+  size_t size() const { return m_count; }
+  bool empty() const { return m_count == 0; }
+
+  /// @returns the item @a _i, or RLP() if @a _i is out of range.
+  RLP operator[](size_t _i) const {
+    if (_i >= m_count) return RLP();
+    const size_t* offsets = reinterpret_cast<const size_t*>(m_offsets.data());
+    return RLP(m_payload.cropped(offsets[_i], offsets[_i + 1] - offsets[_i]),
+               RLP::itemStrictness(m_list.m_trusted));
+  }
+
+  /// The indexed list.
+  RLP const& list() const { return m_list; }
+
+ private:
+  void build();
+
+  void pushOffset(size_t _offset) {
+    const byte* data = reinterpret_cast<const byte*>(&_offset);
+    m_offsets.append(data, data + sizeof(size_t));
+  }
+
+  RLP m_list;
+  bytesConstRef m_payload;
+  /// Start of every item in the payload followed by the payload size.
+  BytesBuffer m_offsets;
+  size_t m_count = 0;
+};
+
+/// Planned size of a list stack entry whose header is written on close.
+static const size_t c_noListPlan = ~size_t(0);
+
 /**
  * @brief Class for writing to an RLP bytestream.
  */
@@ -599,24 +686,36 @@ class RLPStream {
   /// Initializes the RLPStream as a list of @a _listItems items.
   explicit RLPStream(size_t _listItems) { appendList(_listItems); }
 
+  /// Initializes empty RLPStream whose memory is drawn from @a _arena.
+  explicit RLPStream(Arena& _arena)
+      : m_out(_arena), m_listStack(_arena), m_listPlan(_arena) {}
+
+  /// Initializes the RLPStream drawn from @a _arena as a list of @a _listItems
+  /// items.
+  RLPStream(Arena& _arena, size_t _listItems)
+      : m_out(_arena), m_listStack(_arena), m_listPlan(_arena) {
+    appendList(_listItems);
+  }
+
+  /// Initializes empty RLPStream writing into @a _buffer, which must outlive
+  /// the stream. The heap is only used once @a _capacity bytes are exceeded.
+  RLPStream(byte* _buffer, size_t _capacity) : m_out(_buffer, _capacity) {}
+
   ~RLPStream() {}
 
   /// Append given datum to the byte stream.
-  RLPStream& append(bool _b) {
-    unsigned _s = _b ? 1 : 0;
-    return append(bigint(_s));
-  }
+  RLPStream& append(bool _b) { return appendUnsigned(uint8_t(_b ? 1 : 0)); }
   // RLPStream& append(unsigned _s) { return append(bigint(_s)); }
-  RLPStream& append(uint8_t _s) { return append(bigint(_s)); }
-  RLPStream& append(uint16_t _s) { return append(bigint(_s)); }
-  RLPStream& append(uint32_t _s) { return append(bigint(_s)); }
-  RLPStream& append(uint64_t _s) { return append(bigint(_s)); }
+  RLPStream& append(uint8_t _s) { return appendUnsigned(_s); }
+  RLPStream& append(uint16_t _s) { return appendUnsigned(_s); }
+  RLPStream& append(uint32_t _s) { return appendUnsigned(_s); }
+  RLPStream& append(uint64_t _s) { return appendUnsigned(_s); }
   RLPStream& append(bigint _i);
-  RLPStream& append(int8_t _c) { return append(int128_t(_c)); }
-  RLPStream& append(int16_t _s) { return append(int128_t(_s)); }
-  RLPStream& append(int _c) { return append(int128_t(_c)); }
-  RLPStream& append(int32_t _s) { return append(int128_t(_s)); }
-  RLPStream& append(int64_t _s) { return append(int128_t(_s)); }
+  RLPStream& append(int8_t _c) { return appendSigned(_c); }
+  RLPStream& append(int16_t _s) { return appendSigned(_s); }
+  RLPStream& append(int _c) { return appendSigned(_c); }
+  RLPStream& append(int32_t _s) { return appendSigned(_s); }
+  RLPStream& append(int64_t _s) { return appendSigned(_s); }
   RLPStream& append(int128_t _l) {
     uint128_t _i = uint128_t((_l << 1) ^ (_l >> 127));
     return append(_i);
@@ -632,6 +731,10 @@ class RLPStream {
   RLPStream& append(bytesConstRef _s);
   RLPStream& append(bytes const& _s) { return append(bytesConstRef(&_s)); }
   RLPStream& append(std::string const& _s) { return append(bytesConstRef(_s)); }
+  RLPStream& append(std::string_view _s) {
+    return append(
+        bytesConstRef(reinterpret_cast<byte const*>(_s.data()), _s.size()));
+  }
   RLPStream& append(char const* _s) { return append(std::string(_s)); }
   template <unsigned N>
   RLPStream& append(FixedHash<N> _s, bool _allOrNothing = false) {
@@ -651,6 +754,50 @@ class RLPStream {
   //  RLPStream& appendList(RLPStream const& _s) { return appendList(&_s.out());
   //  }
 
+  /// Appends an unsigned integer of at most 64 bits without calling the host,
+  /// the number of payload bytes is bounded by the width of @a _T.
+  template <class _T>
+  RLPStream& appendUnsigned(_T _i) {
+    static_assert(!std::numeric_limits<_T>::is_signed && sizeof(_T) <= 8,
+                  "only unsigned integers up to 64 bits supported");
+    if (_i == 0) {
+      m_out.push_back(c_rlpDataImmLenStart);
+    } else if (_i < c_rlpDataImmLenStart) {
+      m_out.push_back(byte(_i));
+    } else {
+      unsigned br = 8 - (__builtin_clzll(uint64_t(_i)) >> 3);
+      size_t old_size = m_out.size();
+      m_out.resize(old_size + 1 + br);
+      byte* b = m_out.data() + old_size;
+      *b = byte(c_rlpDataImmLenStart + br);
+      for (b += br; _i; _i >>= 8) *(b--) = byte(_i);
+    }
+    noteAppended();
+    return *this;
+  }
+
+  /// Appends a signed integer of at most 64 bits with the zigzag encoding used
+  /// for int128_t, which gives the same bytes for values in range.
+  template <class _T>
+  RLPStream& appendSigned(_T _l) {
+    static_assert(std::numeric_limits<_T>::is_signed && sizeof(_T) <= 8,
+                  "only signed integers up to 64 bits supported");
+    int64_t l = _l;
+    return appendUnsigned(uint64_t((uint64_t(l) << 1) ^ uint64_t(l >> 63)));
+  }
+
+  /// Appends @a _t after sizing it in a single RLPSize traversal. The payload
+  /// size of every list inside @a _t is recorded, so that appendList() writes
+  /// the final header right away and closing a list never moves its payload.
+  /// Serializers called while the plan is active just append their members.
+  template <class _T>
+  RLPStream& appendPlanned(_T const& _t);
+
+  /// Whether list sizes recorded by appendPlanned() are still pending.
+  bool hasListPlan() const {
+    return m_listPlanIndex < m_listPlan.size() / sizeof(size_t);
+  }
+
   /// Appends raw (pre-serialised) RLP data. Use with caution.
   RLPStream& appendRaw(bytesConstRef _s, size_t _itemCount = 1);
   RLPStream& appendRaw(bytes const& _rlp, size_t _itemCount = 1) {
@@ -689,10 +836,11 @@ class RLPStream {
   template <typename... Args>
   RLPStream& operator<<(const std::tuple<Args...>& t);
 
-  /// Clear the output stream so far.
+  /// Clear the output stream so far, the buffers keep their capacity.
   void clear() {
     m_out.clear();
     m_listStack.clear();
+    dropListPlan();
   }
 
   /// Read the byte stream.
@@ -717,6 +865,11 @@ class RLPStream {
     m_out.append(_dest.data(), _dest.data() + _dest.size());
   }
 
+  void appendPrefix(byte _prefix) {
+    if (!m_listStack.empty()) internal::platon_throw("listStack is not empty");
+    m_out.push_back(_prefix);
+  }
+
   void reserve(size_t size) {
     if (m_out.capacity() < size) {
       m_out.reserve(size);
@@ -726,6 +879,18 @@ class RLPStream {
  private:
   void noteAppended(size_t _itemCount = 1);
 
+  /// Writes the header of a list with a payload of @a _size bytes.
+  void pushListHeader(size_t _size);
+
+  /// Rewrites the header of a planned list whose payload differs from the
+  /// plan, the remaining plan is dropped.
+  void fixListHeader(size_t _start, size_t _planned);
+
+  void dropListPlan() {
+    m_listPlan.clear();
+    m_listPlanIndex = 0;
+  }
+
   #ifdef OLD
   void pushCount(size_t _count, byte _base);
 
@@ -738,10 +903,121 @@ class RLPStream {
   }
   #endif
 
+  /// Open lists as (remaining items, start offset, planned payload size).
+  /// The outermost levels are kept inline, deeper ones in a BytesBuffer so
+  /// that they share the allocation strategy of the output. The planned size
+  /// is c_noListPlan when the header is written on close.
+  class ListStack {
+   public:
+    struct value_type {
+      size_t first;
+      size_t second;
+      size_t planned;
+    };
+    static const size_t c_inlineDepth = 4;
+
+    ListStack() {}
+    explicit ListStack(Arena& _arena) : m_overflow(_arena) {}
+
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+    value_type& back() {
+      if (m_size <= c_inlineDepth) return m_inline[m_size - 1];
+      return *reinterpret_cast<value_type*>(
+          m_overflow.data() + m_overflow.size() - sizeof(value_type));
+    }
+    void push_back(const std::pair<size_t, size_t>& _v,
+                   size_t _planned = c_noListPlan) {
+      value_type v{_v.first, _v.second, _planned};
+      if (m_size < c_inlineDepth) {
+        m_inline[m_size] = v;
+      } else {
+        const byte* data = reinterpret_cast<const byte*>(&v);
+        m_overflow.append(data, data + sizeof(value_type));
+      }
+      ++m_size;
+    }
+    void pop_back() {
+      if (m_size > c_inlineDepth)
+        m_overflow.relocate(m_overflow.size() - sizeof(value_type));
+      --m_size;
+    }
+    void clear() {
+      m_overflow.clear();
+      m_size = 0;
+    }
+
+   private:
+    value_type m_inline[c_inlineDepth];
+    size_t m_size = 0;
+    BytesBuffer m_overflow;
+  };
+
   /// Our output byte stream.
   BytesBuffer m_out;
 
-  std::vector<std::pair<size_t, size_t>> m_listStack;
+  ListStack m_listStack;
+
+  /// Payload sizes recorded by appendPlanned() and the next one to use.
+  BytesBuffer m_listPlan;
+  size_t m_listPlanIndex = 0;
+};
+
+/**
+ * @brief RLPStream borrowed from a pool kept for the whole invocation
+ *
+ * The stream is cleared when it goes back to the pool and keeps the capacity
+ * of its buffers, so temporary encodings done over and over, such as state
+ * keys and values or event data, stop allocating once the pool has warmed up.
+ * The pool holds as many streams as were ever in use at the same time.
+ *
+ * Example:
+ *
+ * @code
+  {
+    ScopedStream stream;
+    stream->appendPlanned(value);
+    bytesRef data = stream->out();
+    // ...
+  }  // the stream is available again here
+ * @endcode
+ */
+class ScopedStream {
+ public:
+  ScopedStream() : m_stream(acquire()) {}
+
+  /// Starts the stream as a list of @a _listItems items.
+  explicit ScopedStream(size_t _listItems) : m_stream(acquire()) {
+    m_stream->appendList(_listItems);
+  }
+
+  ~ScopedStream() {
+    m_stream->clear();
+    pool().push_back(m_stream);
+  }
+
+  ScopedStream(const ScopedStream&) = delete;
+  ScopedStream& operator=(const ScopedStream&) = delete;
+
+  RLPStream& operator*() const { return *m_stream; }
+  RLPStream* operator->() const { return m_stream; }
+
+ private:
+  // never destroyed, destructors run from __funcs_on_exit still encode
+  static std::vector<RLPStream*>& pool() {
+    static std::vector<RLPStream*>* streams = new std::vector<RLPStream*>();
+    return *streams;
+  }
+
+  static RLPStream* acquire() {
+    std::vector<RLPStream*>& streams = pool();
+    if (streams.empty()) return new RLPStream();
+    RLPStream* stream = streams.back();
+    streams.pop_back();
+    return stream;
+  }
+
+  RLPStream* m_stream;
 };
 
 template <class _T>
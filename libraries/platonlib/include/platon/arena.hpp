@@ -0,0 +1,178 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+
+namespace platon {
+
+/**
+ * @brief Region allocator with mark/rewind semantics.
+ *
+ * Memory is handed out by bumping a pointer inside blocks obtained from
+ * malloc. Nothing is released one by one: rewinding to a mark makes every
+ * allocation done after the mark available again, while the blocks stay
+ * owned by the arena and are reused by the next allocations. Serialization
+ * scratch buffers built this way cost no permanent heap growth, whatever
+ * allocator the contract is linked with.
+ *
+ * An object drawing from an arena must not be grown inside a nested scope
+ * that is rewound before the object itself goes away.
+ */
+class Arena {
+ public:
+  static constexpr size_t default_block_size = 4096;
+  static constexpr size_t align_size = 8;
+
+ private:
+  struct Block {
+    Block *next;
+    size_t capacity;
+    size_t used;
+  };
+
+  static constexpr size_t header_size =
+      (sizeof(Block) + align_size - 1) & ~(align_size - 1);
+
+ public:
+  /// Position in the arena that can be rewound to.
+  struct Mark {
+    Block *block;
+    size_t used;
+  };
+
+  Arena() : head_(nullptr), current_(nullptr) {}
+  ~Arena() {
+    while (head_ != nullptr) {
+      Block *next = head_->next;
+      ::free(head_);
+      head_ = next;
+    }
+  }
+
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  /**
+   * @brief Allocate memory aligned to 8 bytes
+   *
+   * @param size Number of bytes
+   * @return void* Memory valid until the arena is rewound before this call
+   */
+  void *allocate(size_t size) {
+    size = (size + align_size - 1) & ~(align_size - 1);
+    if (current_ == nullptr || current_->capacity - current_->used < size) {
+      next_block(size);
+    }
+    uint8_t *ptr = data(current_) + current_->used;
+    current_->used += size;
+    return ptr;
+  }
+
+  /**
+   * @brief Current position of the arena
+   *
+   * @return Mark Position to pass to rewind()
+   */
+  Mark mark() const {
+    return Mark{current_, current_ != nullptr ? current_->used : 0};
+  }
+
+  /**
+   * @brief Release every allocation done after the mark
+   *
+   * @param m Position returned by mark()
+   */
+  void rewind(const Mark &m) {
+    if (m.block == nullptr) {
+      current_ = head_;
+      if (current_ != nullptr) current_->used = 0;
+      return;
+    }
+    current_ = m.block;
+    current_->used = m.used;
+  }
+
+  /**
+   * @brief Total bytes owned by the arena
+   *
+   * @return size_t Sum of the block capacities
+   */
+  size_t capacity() const {
+    size_t total = 0;
+    for (Block *b = head_; b != nullptr; b = b->next) total += b->capacity;
+    return total;
+  }
+
+  /**
+   * @brief Arena shared by the library for transient serialization buffers
+   *
+   * @return Arena& The contract wide scratch arena, it is never destroyed so
+   * that destructors run from __funcs_on_exit can still serialize
+   */
+  static Arena &transient() {
+    static Arena *arena = new Arena();
+    return *arena;
+  }
+
+ private:
+  static uint8_t *data(Block *b) {
+    return reinterpret_cast<uint8_t *>(b) + header_size;
+  }
+
+  void next_block(size_t size) {
+    Block *next = current_ != nullptr ? current_->next : head_;
+    if (next != nullptr && next->capacity >= size) {
+      next->used = 0;
+      current_ = next;
+      return;
+    }
+
+    size_t capacity = size > default_block_size ? size : default_block_size;
+    Block *b = static_cast<Block *>(::malloc(header_size + capacity));
+    b->next = next;
+    b->capacity = capacity;
+    b->used = 0;
+    if (current_ != nullptr) {
+      current_->next = b;
+    } else {
+      head_ = b;
+    }
+    current_ = b;
+  }
+
+  Block *head_;
+  Block *current_;
+};
+
+/**
+ * @brief Rewinds an arena to the position it had at construction
+ *
+ * Example:
+ *
+ * @code
+  {
+    ScopedArena scope;
+    RLPStream stream(scope.arena());
+    stream << key;
+    // ...
+  }  // the stream memory is available again here
+ * @endcode
+ */
+class ScopedArena {
+ public:
+  explicit ScopedArena(Arena &arena = Arena::transient())
+      : arena_(arena), mark_(arena.mark()) {}
+  ~ScopedArena() { arena_.rewind(mark_); }
+
+  ScopedArena(const ScopedArena &) = delete;
+  ScopedArena &operator=(const ScopedArena &) = delete;
+
+  Arena &arena() { return arena_; }
+  void *allocate(size_t size) { return arena_.allocate(size); }
+
+ private:
+  Arena &arena_;
+  Arena::Mark mark_;
+};
+
+}  // namespace platon
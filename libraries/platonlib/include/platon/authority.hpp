@@ -1,6 +1,7 @@
 #pragma once
 #include "bech32.hpp"
 #include "chain.hpp"
+#include "db/set.hpp"
 #include "fixedhash.hpp"
 #include "storagetype.hpp"
 
@@ -97,6 +98,12 @@ bool is_owner(const std::string &addr = std::string()) {
 /**
  * @brief Persist storage whitelist implement
  *
+ * Each address is stored under a key of its own, checking, adding or deleting
+ * one costs a single state access whatever the size of the whitelist.
+ * Whitelists stored by older versions as a single encoded set are moved to
+ * the new layout on the first access. That access reads the key of the old
+ * set once per WhiteList object.
+ *
  * @tparam Name Whitelist name, in the same contract, the name should be unique
  */
 template <Name::Raw TableName>
@@ -118,11 +125,14 @@ class WhiteList {
   }
 
   /**
-   * @brief Add the address to whitelist
+   * @brief Add the address to whitelist, adding a member writes nothing
    *
    * @param addr Accounts address
    */
-  void Add(const Address &addr) { whitelist_.self().insert(addr); }
+  void Add(const Address &addr) {
+    Migrate();
+    whitelist_.insert(addr);
+  }
 
   /**
    * @brief Delete the address from whitelist
@@ -139,7 +149,10 @@ class WhiteList {
    *
    * @param addr Accounts address
    */
-  void Delete(const Address &addr) { whitelist_.self().erase(addr); }
+  void Delete(const Address &addr) {
+    Migrate();
+    whitelist_.erase(addr);
+  }
 
   /**
    * @brief Whether the address exists in whitelist
@@ -160,11 +173,31 @@ class WhiteList {
    * @return true if exists, false otherwise
    */
   bool Exists(const Address &addr) {
-    return whitelist_.self().find(addr) != whitelist_.self().end();
+    Migrate();
+    return whitelist_.contains(addr);
+  }
+
+  /**
+   * @brief Move the addresses of a whitelist stored by an older version as a
+   * single encoded set to the per address keys, and delete the old set. The
+   * other member functions call it on the first access. In a CONST action the
+   * moved addresses are only known to this object.
+   *
+   * @return size_t Number of moved addresses
+   */
+  size_t Migrate() {
+    if (migrated_) return 0;
+    migrated_ = true;
+    std::set<Address> old;
+    if (get_state(uint64_t(TableName), old) == 0) return 0;
+    for (const Address &addr : old) whitelist_.insert(addr);
+    del_state(uint64_t(TableName));
+    return old.size();
   }
 
  private:
-  Set<TableName, Address> whitelist_;
+  db::Set<TableName, Address> whitelist_;
+  bool migrated_ = false;
 };
 
 /**
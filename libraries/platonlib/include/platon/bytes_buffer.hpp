@@ -2,6 +2,7 @@
 // Created by yangzhou on 3/2/20.
 //
 #include <string>
+#include "arena.hpp"
 #include "common.h"
 #include "print.hpp"
 #include "vector_ref.h"
@@ -11,10 +12,38 @@ namespace platon {
 class BytesBuffer {
  public:
   explicit BytesBuffer(size_t capacity = 0)
-      : buffer_(nullptr), size_(0), capacity_(0) {
+      : buffer_(nullptr),
+        size_(0),
+        capacity_(0),
+        arena_(nullptr),
+        external_(false) {
     reserve(capacity);
   }
-  BytesBuffer(BytesBuffer &&other) noexcept { move(std::move(other)); }
+  /// The buffer memory is drawn from @a arena and never freed by the buffer.
+  explicit BytesBuffer(Arena &arena, size_t capacity = 0)
+      : buffer_(nullptr),
+        size_(0),
+        capacity_(0),
+        arena_(&arena),
+        external_(false) {
+    reserve(capacity);
+  }
+  /// The buffer starts in @a storage, which must outlive it, and only moves
+  /// to the heap when more than @a capacity bytes are needed.
+  BytesBuffer(uint8_t *storage, size_t capacity)
+      : buffer_(storage),
+        size_(0),
+        capacity_(capacity),
+        arena_(nullptr),
+        external_(true) {}
+  BytesBuffer(BytesBuffer &&other) noexcept
+      : buffer_(nullptr),
+        size_(0),
+        capacity_(0),
+        arena_(nullptr),
+        external_(false) {
+    move(std::move(other));
+  }
 
   ~BytesBuffer() { destory(); }
 
@@ -39,7 +68,7 @@ class BytesBuffer {
   }
   void clear() { size_ = 0; }
   void resize(size_t num) {
-    reserve(num);
+    grow(num);
     size_ = num;
   }
   uint8_t &back() { return *(buffer_ + (size_ - 1)); }
@@ -62,18 +91,25 @@ class BytesBuffer {
   }
   void reserve(size_t size) {
     if (capacity_ < size) {
-      uint8_t *tmp = (uint8_t *)malloc(size);
+      uint8_t *tmp = arena_ != nullptr ? (uint8_t *)arena_->allocate(size)
+                                       : (uint8_t *)malloc(size);
       memcpy(tmp, buffer_, size_);
       destory();
       buffer_ = tmp;
       capacity_ = size;
+      external_ = false;
     }
   }
 
  private:
   void expand(size_t num) {
-    if (size_ + num > capacity_) {
-      reserve(size_ + num);
+    grow(size_ + num);
+  }
+  void grow(size_t size) {
+    if (size > capacity_) {
+      // arena memory is only given back on rewind, grow geometrically there
+      if (arena_ != nullptr && size < 2 * capacity_) size = 2 * capacity_;
+      reserve(size);
     }
   }
   void move(BytesBuffer &&other) {
@@ -81,12 +117,14 @@ class BytesBuffer {
     buffer_ = other.buffer_;
     size_ = other.size_;
     capacity_ = other.capacity_;
+    arena_ = other.arena_;
+    external_ = other.external_;
     other.buffer_ = nullptr;
     other.size_ = 0;
     other.capacity_ = 0;
   }
   void destory() {
-    if (buffer_ != nullptr) {
+    if (buffer_ != nullptr && arena_ == nullptr && !external_) {
       ::free(buffer_);
     }
   }
@@ -95,5 +133,7 @@ class BytesBuffer {
   uint8_t *buffer_;
   size_t size_;
   size_t capacity_;
+  Arena *arena_;
+  bool external_;
 };  // namespace platon
 }  // namespace platon
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "exchange.hpp"
 #include "fixedhash.hpp"
 #include "rlp_extend.hpp"
+#include "state_cache.hpp"
 
 namespace platon {
 
@@ -162,6 +163,7 @@ void platon_debug(const std::string &data) {
  * @return true if destroy successfully, false otherwise
  */
 bool platon_destroy(const Address &addr) {
+  StateCache::instance().flush();
   return ::platon_destroy(addr.data()) == 0;
 }
 
@@ -2,6 +2,21 @@
 
 #define PLATON_ABI(NAME, MEMBER)
 #define ACTION __attribute__((used, annotate("Action")))
+
+/**
+ * Declares a query action, marked constant in the ABI.
+ *
+ * A CONST action must be a const member function and a const member function
+ * exported as an action must be CONST, platon-cpp rejects either mismatch.
+ * The dispatcher runs const member functions read only: every state write of
+ * the call, including the ones storage objects flush when the contract is
+ * destroyed, is dropped, so a query only pays for its reads.
+ *
+ * Example:
+ * @code
+ * CONST uint64_t get() const { return stored_.self(); }
+ * @endcode
+ */
 #define CONST __attribute__((used, annotate("Const")))
 #define EVENT __attribute__((used, annotate("Event0")))
 #define EVENT1 __attribute__((used, annotate("Event1")))
@@ -27,15 +27,16 @@ std::pair<Address, bool> platon_create_contract(const bytes &code,
   bytes init_rlp = cross_call_args("init", init_args...);
   RLPSize rlps;
   rlps << code << init_rlp;
-  RLPStream stream;
-  stream.appendPrefix(magic_number);
-  stream.reserve(rlps.size() + 4);
-  stream.appendList(2);
-  stream << code << init_rlp;
-  bytesRef result = stream.out();
+  ScopedStream stream;
+  stream->appendPrefix(magic_number);
+  stream->reserve(rlps.size() + 4);
+  stream->appendList(2);
+  *stream << code << init_rlp;
+  bytesRef result = stream->out();
 
   // deploy contract
   Address return_address;
+  StateCache::instance().flush();
   bool success =
       platon_deploy(return_address.data(), result.data(), result.size(),
                     value_bytes.data(), value_bytes.size(), gas_bytes.data(),
@@ -57,6 +58,7 @@ std::pair<Address, bool> platon_create_contract(const Address &address,
 
   // clone contract
   Address return_address;
+  StateCache::instance().flush();
   bool success =
       platon_clone(address.data(), return_address.data(), init_rlp.data(),
                    init_rlp.size(), value_bytes.data(), value_bytes.size(),
@@ -9,27 +9,28 @@
 #include "boost/preprocessor/seq/for_each.hpp"
 
 #include "RLP.h"
+#include "arena.hpp"
 #include "chain.hpp"
 #include "common.h"
 #include "fixedhash.hpp"
 #include "name.hpp"
 #include "rlp_extend.hpp"
+#include "rlp_view.hpp"
+#include "state_cache.hpp"
 
 namespace platon {
 
 /**
- * @brief Construct the parameters of the call across contracts
+ * @brief Construct the parameters of the call across contracts into a stream
  *
+ * @param stream The stream receiving the encoded parameters
  * @param method The method name of the invoked contract
  * @param args The parameters corresponding to the contract method
- *
- * @return Parameter byte array
  */
 template <typename... Args>
-inline bytes cross_call_args(const std::string &method,
-                                     const Args &... args) {
+inline void cross_call_args(RLPStream &stream, const std::string &method,
+                            const Args &... args) {
   uint64_t t_method = Name(method).value;
-  RLPStream stream;
   std::tuple<Args...> tuple_args = std::make_tuple(args...);
   size_t num = sizeof...(Args);
   stream.appendList(num + 1);
@@ -39,7 +40,22 @@ inline bytes cross_call_args(const std::string &method,
   stream.reserve(rlps.size());
   stream << t_method;
   boost::fusion::for_each(tuple_args, [&](const auto &i) { stream << i; });
-  return stream.out().toBytes();
+}
+
+/**
+ * @brief Construct the parameters of the call across contracts
+ *
+ * @param method The method name of the invoked contract
+ * @param args The parameters corresponding to the contract method
+ *
+ * @return Parameter byte array
+ */
+template <typename... Args>
+inline bytes cross_call_args(const std::string &method,
+                                     const Args &... args) {
+  ScopedStream stream;
+  cross_call_args(*stream, method, args...);
+  return stream->out().toBytes();
 }
 
 /**
@@ -59,6 +75,23 @@ inline bytes value_to_bytes(T value) {
   return result;
 }
 
+/**
+ * @brief Converts the data to a big-end representation in a buffer
+ *
+ * @param buffer Buffer receiving the bytes of the value
+ * @param value Data values to be converted
+ *
+ * @return A reference to the bytes of the value inside the buffer
+ */
+template <typename T>
+inline bytesRef value_to_bytes(BytesBuffer &buffer, T value) {
+  unsigned byte_count = bytesRequired(value);
+  buffer.resize(byte_count);
+  byte *b = buffer.data() + byte_count - 1;
+  for (; value; value >>= 8) *(b--) = (byte)value;
+  return buffer.out();
+}
+
 /**
  * @brief Normal cross-contract invocation
  *
@@ -75,6 +108,7 @@ inline bool platon_call(const Address &addr, const bytes &paras,
                         const value_type &value, const gas_type &gas) {
   bytes value_bytes = value_to_bytes(value);
   bytes gas_bytes = value_to_bytes(gas);
+  StateCache::instance().flush();
   return ::platon_call(addr.data(), paras.data(), paras.size(),
                        value_bytes.data(), value_bytes.size(), gas_bytes.data(),
                        gas_bytes.size()) == 0;
@@ -94,6 +128,7 @@ template <typename gas_type>
 inline bool platon_delegate_call(const Address &addr, const bytes &paras,
                                  const gas_type &gas) {
   bytes gas_bytes = value_to_bytes(gas);
+  StateCache::instance().flush();
   return ::platon_delegate_call(addr.data(), paras.data(), paras.size(),
                                 gas_bytes.data(), gas_bytes.size()) == 0;
 }
@@ -116,11 +151,13 @@ inline bool platon_delegate_call(const Address &addr, const bytes &paras,
  */
 template <typename T>
 inline void get_call_output(T &t) {
-  bytes result;
+  ScopedArena scope;
   size_t len = ::platon_get_call_output_length();
-  result.resize(len);
-  ::platon_get_call_output(result.data());
-  fetch(RLP(result), t);
+  // views decoded from the output borrow it for the rest of the call
+  byte *result = static_cast<byte *>(rlp_borrows_v<T> ? ::malloc(len)
+                                                      : scope.allocate(len));
+  ::platon_get_call_output(result);
+  fetch(RLP(result, len), t);
 }
 
 /**
@@ -152,9 +189,15 @@ template <typename value_type, typename gas_type, typename... Args>
 inline bool platon_call(const Address &addr, const value_type &value,
                         const gas_type &gas, const std::string &method,
                         const Args &... args) {
-  bytes paras = cross_call_args(method, args...);
-  bytes value_bytes = value_to_bytes(value);
-  bytes gas_bytes = value_to_bytes(gas);
+  ScopedStream stream;
+  cross_call_args(*stream, method, args...);
+  const bytesRef paras = stream->out();
+  ScopedArena scope;
+  BytesBuffer value_buffer(scope.arena());
+  BytesBuffer gas_buffer(scope.arena());
+  const bytesRef value_bytes = value_to_bytes(value_buffer, value);
+  const bytesRef gas_bytes = value_to_bytes(gas_buffer, gas);
+  StateCache::instance().flush();
   int32_t result =
       ::platon_call(addr.data(), paras.data(), paras.size(), value_bytes.data(),
                     value_bytes.size(), gas_bytes.data(), gas_bytes.size());
@@ -229,8 +272,13 @@ template <typename gas_type, typename... Args>
 inline bool platon_delegate_call(const Address &addr, const gas_type &gas,
                                  const std::string &method,
                                  const Args &... args) {
-  bytes paras = cross_call_args(method, args...);
-  bytes gas_bytes = value_to_bytes(gas);
+  ScopedStream stream;
+  cross_call_args(*stream, method, args...);
+  const bytesRef paras = stream->out();
+  ScopedArena scope;
+  BytesBuffer gas_buffer(scope.arena());
+  const bytesRef gas_bytes = value_to_bytes(gas_buffer, gas);
+  StateCache::instance().flush();
   int32_t result =
       ::platon_delegate_call(addr.data(), paras.data(), paras.size(),
                              gas_bytes.data(), gas_bytes.size());
@@ -3,6 +3,8 @@
 #include <map>
 #include "platon/assert.hpp"
 #include "platon/name.hpp"
+#include "platon/db/state_key.hpp"
+#include "platon/db/tracked.hpp"
 #include "platon/storage.hpp"
 
 namespace platon {
@@ -13,6 +15,10 @@ namespace db {
  * @tparam *Name Array name, in the same contract, the name should be unique
  * @tparam Key Array element type
  * @tparam Size Array length
+ *
+ * Elements read through get() are cached and never written back. at() and
+ * operator[] return a mutable reference, the element is written back only if
+ * it changed.
  */
 template <Name::Raw TableName, typename Key, unsigned N>
 class Array {
@@ -24,7 +30,7 @@ class Array {
   class iterator : public std::iterator<std::bidirectional_iterator_tag, Key> {
    public:
     friend bool operator==(const iterator& a, const iterator& b) {
-      return a.array_ == b.array_ && a.pos_ = b.pos_;
+      return a.array_ == b.array_ && a.pos_ == b.pos_;
     }
     friend bool operator!=(const iterator& a, const iterator& b) {
       return a.array_ != b.array_ || a.pos_ != b.pos_;
@@ -90,7 +96,7 @@ class Array {
       : public std::iterator<std::bidirectional_iterator_tag, const Key> {
    public:
     friend bool operator==(const const_iterator& a, const const_iterator& b) {
-      return a.array_ == b.array_ && a.pos_ = b.pos_;
+      return a.array_ == b.array_ && a.pos_ == b.pos_;
     }
     friend bool operator!=(const const_iterator& a, const const_iterator& b) {
       return a.array_ != b.array_ || a.pos_ != b.pos_;
@@ -164,7 +170,7 @@ class Array {
    public:
     friend bool operator==(const const_reverse_iterator& a,
                            const const_reverse_iterator& b) {
-      return a.array_ == b.array_ && a.pos_ = b.pos_;
+      return a.array_ == b.array_ && a.pos_ == b.pos_;
     }
     friend bool operator!=(const const_reverse_iterator& a,
                            const const_reverse_iterator& b) {
@@ -333,18 +339,24 @@ class Array {
    * assert(name.at[0] = "hello");
    * @endcode
    */
-  Key& at(size_t pos) {
-    platon_assert(pos < N, "out of range pos:", pos, "size:", N);
-    auto iter = cache_.find(pos);
-    if (iter != cache_.end()) {
-      return iter->second;
-    }
-    Key key;
-    get_state(EncodeKey(pos), key);
-    auto iterc = cache_.emplace(std::make_pair(pos, key));
-    platon_assert(iterc.second, "cache emplace failed");
-    return iterc.first->second;
-  }
+  Key& at(size_t pos) { return Load(pos).expose(); }
+
+  /**
+   * @brief Get the specified position element for reading, it is cached but
+   * never written back
+   *
+   * @param pos Element position
+   * @return const Key& Element value
+   * Example:
+   *
+   * @code
+   * typedef platon::db::Array<"name_test"_n, std::string, 3> ArrayName;
+   * ArrayName name;
+   * name[0] = "hello";
+   * assert(name.get(0) == "hello");
+   * @endcode
+   */
+  const Key& get(size_t pos) const { return Load(pos).get(); }
 
   /**
    * @brief Bracket operator
@@ -373,7 +385,7 @@ class Array {
    * assert(name.size() == 3);
    * @endcode
    */
-  size_t size() { return N; }
+  size_t size() const { return N; }
 
   /**
    * @brief Get the Const object. Do not flush to cache
@@ -389,10 +401,10 @@ class Array {
    * assert(name.get_const(0) == "hello");
    * @endcode
    */
-  Key get_const(size_t pos) {
+  Key get_const(size_t pos) const {
     auto iter = cache_.find(pos);
     if (iter != cache_.end()) {
-      return iter->second;
+      return iter->second.get();
     }
     Key key;
     get_state(EncodeKey(pos), key);
@@ -417,36 +429,65 @@ class Array {
   void set_const(size_t pos, const Key& key) {
     auto iter = cache_.find(pos);
     if (iter != cache_.end()) {
-      cache_[pos] = key;
+      iter->second.modify() = key;
+      iter->second.stored();
     }
     set_state(EncodeKey(pos), key);
   }
 
  private:
+  // the key is the string of the name bytes, 'A' and the index bytes
+  static constexpr size_t kKeySize = sizeof(uint64_t) + 1 + sizeof(size_t);
+  typedef EncodedKey<kKeySize + 1> StateKey;
+
+  static constexpr StateKey KeyPrefix() {
+    StateKey key{};
+    key.data[0] = byte(0x80 + kKeySize);
+    for (size_t i = 0; i < sizeof(uint64_t); i++) {
+      key.data[1 + i] = byte(uint64_t(TableName) >> (i * 8));
+    }
+    key.data[1 + sizeof(uint64_t)] = 'A';
+    return key;
+  }
+
   /**
    * @brief Generate the key of the specified index
    *
    * @param index
-   * @return std::string
+   * @return StateKey The encoded key, only the index is written at runtime
    */
-  std::string EncodeKey(size_t index) {
-    std::string key;
-    key.reserve(sizeof(name_) + 1 + sizeof(index));
-    key.append((char*)&name_, sizeof(name_));
-    key.append(1, 'A');
-    key.append((char*)&index, sizeof(index));
+  static StateKey EncodeKey(size_t index) {
+    constexpr StateKey prefix = KeyPrefix();
+    StateKey key = prefix;
+    ::memcpy(key.data.data() + 2 + sizeof(uint64_t), &index, sizeof(index));
     return key;
   }
 
  private:
   /**
-   * @brief Refresh data to blockchain
+   * @brief Cached element of the position, read from the blockchain on first
+   * use
+   *
+   */
+  Tracked<Key>& Load(size_t pos) const {
+    platon_assert(pos < N, "out of range pos:", pos, "size:", N);
+    auto iter = cache_.find(pos);
+    if (iter != cache_.end()) {
+      return iter->second;
+    }
+    Key key;
+    bool stored = get_state(EncodeKey(pos), key) != 0;
+    return cache_.emplace(pos, Tracked<Key>(std::move(key), stored))
+        .first->second;
+  }
+
+  /**
+   * @brief Refresh the changed elements to blockchain
    *
    */
   void Flush() {
-    for (auto iter : cache_) {
-      std::string key = EncodeKey(iter.first);
-      set_state(key, iter.second);
+    for (auto& item : cache_) {
+      item.second.flush(EncodeKey(item.first));
     }
   }
 
@@ -454,9 +495,7 @@ class Array {
   static const std::string kType;
 
  private:
-  std::map<size_t, Key> cache_;
-
-  const uint64_t name_ = uint64_t(TableName);
+  mutable std::map<size_t, Tracked<Key>> cache_;
 };
 
 template <Name::Raw TableName, typename Key, unsigned N>
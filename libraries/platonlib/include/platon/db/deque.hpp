@@ -0,0 +1,261 @@
+#pragma once
+
+#include <map>
+#include <utility>
+#include "platon/assert.hpp"
+#include "platon/db/state_key.hpp"
+#include "platon/db/tracked.hpp"
+#include "platon/name.hpp"
+#include "platon/storage.hpp"
+
+namespace platon {
+namespace db {
+/**
+ * @brief Double-ended queue whose elements are stored under their own keys
+ *
+ * The head and tail counters are kept in a slot of their own, each element
+ * under the key of its slot. The counters wrap around, so the queue can grow
+ * at both ends without ever moving an element. Elements are read from the
+ * blockchain when they are first used, pushing, popping and indexed access
+ * cost a constant number of state accesses whatever the length. Elements
+ * read through get() are never written back, at() and operator[] return a
+ * mutable reference and the element is written back only if it changed.
+ *
+ * @tparam TableName Deque name, in the same contract, the name should be
+ * unique
+ * @tparam T Element type
+ */
+template <Name::Raw TableName, typename T>
+class Deque {
+ public:
+  Deque() {}
+
+  Deque(const Deque<TableName, T>&) = delete;
+  Deque(const Deque<TableName, T>&&) = delete;
+  Deque<TableName, T>& operator=(const Deque<TableName, T>&) = delete;
+
+  /**
+   * @brief Destroy the Deque object. Refresh the changed elements and the
+   * counters to blockchain
+   *
+   */
+  ~Deque() { Flush(); }
+
+  /**
+   * @brief Number of elements
+   *
+   * @return size_t
+   */
+  size_t size() const {
+    LoadBounds();
+    return size_t(tail_ - head_);
+  }
+
+  bool empty() const { return size() == 0; }
+
+  /**
+   * @brief Append an element at the back, no element is read
+   *
+   * @param value Element value
+   * Example:
+   *
+   * @code
+   * typedef platon::db::Deque<"queue"_n, std::string> Queue;
+   * Queue queue;
+   * queue.push_back("hello");
+   * queue.push_front("world");
+   * assert(queue.front() == "world");
+   * @endcode
+   */
+  void push_back(const T& value) {
+    LoadBounds();
+    cache_[tail_++].modify() = value;
+  }
+
+  /**
+   * @brief Insert an element at the front, no element is read
+   *
+   * @param value Element value
+   */
+  void push_front(const T& value) {
+    LoadBounds();
+    cache_[--head_].modify() = value;
+  }
+
+  /**
+   * @brief Remove the last element, it is not read
+   *
+   */
+  void pop_back() {
+    platon_assert(size() > 0, "pop_back on empty deque");
+    cache_[--tail_].erase();
+  }
+
+  /**
+   * @brief Remove the first element, it is not read
+   *
+   */
+  void pop_front() {
+    platon_assert(size() > 0, "pop_front on empty deque");
+    cache_[head_++].erase();
+  }
+
+  /**
+   * @brief Get the element at @a pos from the front, written back if it is
+   * changed through the returned reference
+   *
+   * @param pos Element position
+   * @return T& Element value
+   */
+  T& at(size_t pos) { return Load(pos).expose(); }
+
+  /**
+   * @brief Bracket operator
+   *
+   * @param pos position
+   * @return T& element
+   */
+  T& operator[](size_t pos) { return at(pos); }
+
+  /**
+   * @brief Get the element at @a pos from the front for reading, it is cached
+   * but never written back
+   *
+   * @param pos Element position
+   * @return const T& Element value
+   */
+  const T& get(size_t pos) const { return Load(pos).get(); }
+
+  /**
+   * @brief Get the element at @a pos from the front without caching it
+   *
+   * @param pos Element position
+   * @return T Element value
+   */
+  T get_const(size_t pos) const {
+    platon_assert(pos < size(), "out of range pos:", pos, "size:", size());
+    auto iter = cache_.find(head_ + pos);
+    if (iter != cache_.end()) {
+      return iter->second.get();
+    }
+    T value;
+    get_state(ElementKey(head_ + pos), value);
+    return value;
+  }
+
+  T& back() { return at(size() - 1); }
+  const T& back() const { return get(size() - 1); }
+  T& front() { return at(0); }
+  const T& front() const { return get(0); }
+
+  /**
+   * @brief Pop at most @a count elements from the front, handing each one to
+   * @a f. A long queue can be processed a batch per call.
+   *
+   * @param count Maximum number of elements
+   * @param f Called with each element, in order
+   * @return size_t The number of popped elements
+   * Example:
+   *
+   * @code
+   * typedef platon::db::Deque<"queue"_n, std::string> Queue;
+   * Queue queue;
+   * queue.drain(10, [](const std::string& request) {
+   *   // ...
+   * });
+   * @endcode
+   */
+  template <typename F>
+  size_t drain(size_t count, F&& f) {
+    size_t n = 0;
+    for (; n < count && !empty(); n++) {
+      f(get_const(0));
+      pop_front();
+    }
+    return n;
+  }
+
+  /**
+   * @brief Visit at most @a count elements starting at @a first from the
+   * front, without caching them
+   *
+   * @param first First position
+   * @param count Maximum number of elements
+   * @param f Called with the position and the element value
+   * @return size_t The position after the last visited element
+   */
+  template <typename F>
+  size_t for_each(size_t first, size_t count, F&& f) const {
+    if (first >= size()) return first;
+    size_t last = size() - first < count ? size() : first + count;
+    for (size_t pos = first; pos < last; pos++) {
+      f(pos, get_const(pos));
+    }
+    return last;
+  }
+
+ public:
+  static const std::string kType;
+
+ private:
+  static constexpr Name::Raw kTag = "__deque__"_n;
+  typedef PrefixedKey<KeyPrefix<TableName, kTag>> BoundsKey;
+  typedef PrefixedKey<KeyPrefix<TableName, kTag>, uint64_t> ElementKey;
+
+  /**
+   * @brief Read the head and tail counters from the blockchain on first use
+   *
+   */
+  void LoadBounds() const {
+    if (bounds_loaded_) return;
+    get_state(BoundsKey(), stored_);
+    head_ = stored_.first;
+    tail_ = stored_.second;
+    bounds_loaded_ = true;
+  }
+
+  /**
+   * @brief Cached element of the position, read from the blockchain on first
+   * use
+   *
+   */
+  Tracked<T>& Load(size_t pos) const {
+    platon_assert(pos < size(), "out of range pos:", pos, "size:", size());
+    uint64_t slot = head_ + pos;
+    auto iter = cache_.find(slot);
+    if (iter != cache_.end()) {
+      return iter->second;
+    }
+    T value;
+    bool stored = get_state(ElementKey(slot), value) != 0;
+    return cache_.emplace(slot, Tracked<T>(std::move(value), stored))
+        .first->second;
+  }
+
+  /**
+   * @brief Refresh the changed elements and the counters to blockchain
+   *
+   */
+  void Flush() {
+    for (auto& item : cache_) {
+      item.second.flush(ElementKey(item.first));
+    }
+    if (!bounds_loaded_) return;
+    std::pair<uint64_t, uint64_t> bounds(head_, tail_);
+    if (bounds != stored_) {
+      set_state(BoundsKey(), bounds);
+      stored_ = bounds;
+    }
+  }
+
+  mutable std::map<uint64_t, Tracked<T>> cache_;
+  mutable uint64_t head_ = 0;
+  mutable uint64_t tail_ = 0;
+  mutable std::pair<uint64_t, uint64_t> stored_;
+  mutable bool bounds_loaded_ = false;
+};
+
+template <Name::Raw TableName, typename T>
+const std::string Deque<TableName, T>::kType = "__deque__";
+}  // namespace db
+}  // namespace platon
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "platon/db/state_key.hpp"
+#include "platon/db/tracked.hpp"
 #include "platon/name.hpp"
 #include "platon/rlp_serialize.hpp"
 #include "platon/storage.hpp"
@@ -15,33 +17,20 @@ namespace db {
  * @tparam MapType::Traverse The default is Traverse, when Traverse needs extra
  * data structure to operate, set to NoTraverse when no traversal operation is
  * needed.
+ *
+ * Values read through get() are cached and never written back. at() and
+ * operator[] return a mutable reference, the value is written back only if
+ * it changed.
  */
 template <Name::Raw TableName, typename Key, typename Value>
 class Map {
  public:
   /**
-   * @brief KeyWrapper
+   * @brief KeyWrapper, the RLP list of the map name and the key with the name
+   * encoded at compile time
    *
    */
-  class KeyWrapper {
-   public:
-    /**
-     * @brief Construct a new Key Wrapper object
-     *
-     * @param name first name
-     * @param key key
-     */
-    KeyWrapper(uint64_t name, const Key &key) : name_(name), key_(key) {}
-    /**
-     * @brief Construct a new platon serialize object
-     *
-     * @param name_
-     */
-    PLATON_SERIALIZE(KeyWrapper, (name_)(key_))
-   private:
-    const uint64_t name_;
-    const Key &key_;
-  };
+  typedef PrefixedKey<KeyPrefix<TableName>, Key> KeyWrapper;
 
  public:
   Map() {}
@@ -74,8 +63,7 @@ class Map {
    */
   bool insert(const Key &k, const Value &v) {
     init();
-    map_[k] = v;
-    modify_.insert(k);
+    map_[k].modify() = v;
     return true;
   }
 
@@ -98,11 +86,13 @@ class Map {
    */
   bool insert_const(const Key &k, const Value &v) {
     init();
-    if (map_.find(k) != map_.end()) {
-      map_[k] = v;
+    auto iter = map_.find(k);
+    if (iter != map_.end()) {
+      iter->second.modify() = v;
+      iter->second.stored();
     }
 
-    platon::set_state(KeyWrapper(keyPrefix_, k), v);
+    platon::set_state(KeyWrapper(k), v);
     return true;
   }
 
@@ -121,20 +111,41 @@ class Map {
    * assert(map.get_const["hello"] == "world");
    * @endcode
    */
-  Value get_const(const Key &k) {
+  Value get_const(const Key &k) const {
     init();
     auto iter = map_.find(k);
     if (iter != map_.end()) {
-      return iter->second;
+      return iter->second.get();
     }
 
     Value v;
-    platon::get_state(KeyWrapper(keyPrefix_, k), v);
+    platon::get_state(KeyWrapper(k), v);
     return v;
   }
 
   /**
-   * @brief Get value, will be added to the cache
+   * @brief Get value for reading, will be added to the cache but never
+   * written back
+   *
+   * @param k Key
+   * @return const Value&
+   * Example:
+   *
+   * @code
+   * typedef platon::db::Map<"map_str"_n, std::string, std::string> MapStr;
+   * MapStr map;
+   * map.insert("hello", "world");
+   * assert(map.get("hello") == "world");
+   * @endcode
+   */
+  const Value &get(const Key &k) const {
+    init();
+    return Load(k).get();
+  }
+
+  /**
+   * @brief Get value, will be added to the cache and written back if it is
+   * changed through the returned reference
    *
    * @param k Key
    * @return Value&
@@ -149,16 +160,7 @@ class Map {
    */
   Value &at(const Key &k) {
     init();
-    auto iter = map_.find(k);
-    if (iter != map_.end()) {
-      return iter->second;
-    }
-
-    Value v;
-    platon::get_state(KeyWrapper(keyPrefix_, k), v);
-    map_[k] = v;
-    modify_.insert(k);
-    return map_[k];
+    return Load(k).expose();
   }
 
   /**
@@ -176,11 +178,7 @@ class Map {
    */
   void erase(const Key &k) {
     init();
-    auto iter = map_.find(k);
-    if (iter != map_.end()) {
-      map_.erase(iter);
-    }
-    modify_.insert(k);
+    map_[k].erase();
   }
 
   /**
@@ -216,15 +214,13 @@ class Map {
    * assert(map.contains("hello"));
    * @endcode
    */
-  bool contains(const Key &key) {
+  bool contains(const Key &key) const {
     init();
     auto iter = map_.find(key);
     if (iter != map_.end()) {
-      return true;
-    } else if (modify_.find(key) != modify_.end()) {
-      return false;
+      return iter->second.exists();
     }
-    return platon::has_state(KeyWrapper(keyPrefix_, key));
+    return platon::has_state(KeyWrapper(key));
   }
 
   //    /**
@@ -238,18 +234,13 @@ class Map {
   //      return keySet_.size();
   //    }
   /**
-   * @brief Refresh the modified data in memory to the blockchain
+   * @brief Refresh the changed data in memory to the blockchain
    *
    */
   void flush() {
-    std::for_each(modify_.begin(), modify_.end(), [this](const Key &k) {
-      auto iter = map_.find(k);
-      if (iter != map_.end()) {
-        platon::set_state(KeyWrapper(keyPrefix_, k), iter->second);
-      } else {
-        platon::del_state(KeyWrapper(keyPrefix_, k));
-      }
-    });
+    for (auto &item : map_) {
+      item.second.flush(KeyWrapper(item.first));
+    }
   }
 
  public:
@@ -260,13 +251,27 @@ class Map {
    * @brief Initialize, get data from the blockchain
    *
    */
-  void init() {
+  void init() const {
     //      platon::get_state(sizePrefix, size_);
   }
 
-  std::map<Key, Value> map_;
-  std::set<Key> modify_;
-  const uint64_t keyPrefix_ = uint64_t(TableName);
+  /**
+   * @brief Cached entry of the key, read from the blockchain on first use
+   *
+   */
+  Tracked<Value> &Load(const Key &k) const {
+    auto iter = map_.find(k);
+    if (iter != map_.end()) {
+      return iter->second;
+    }
+
+    Value v;
+    bool stored = platon::get_state(KeyWrapper(k), v) != 0;
+    return map_.emplace(k, Tracked<Value>(std::move(v), stored))
+        .first->second;
+  }
+
+  mutable std::map<Key, Tracked<Value>> map_;
   //    const std::string sizePrefix = kType + string("s_") + Name;
   //    size_t size_ = 0;
 
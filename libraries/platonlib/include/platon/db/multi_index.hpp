@@ -1,7 +1,10 @@
 #pragma once
 #include <boost/hana.hpp>
 #include <set>
+#include <tuple>
 #include <type_traits>
+#include "platon/db/ordered_index.hpp"
+#include "platon/db/state_key.hpp"
 #include "platon/name.hpp"
 #include "platon/print.hpp"
 #include "platon/storagetype.hpp"
@@ -11,25 +14,14 @@ namespace db {
 
 namespace hana = boost::hana;
 
-template <typename T>
-struct IndexKey {
-  uint64_t table_name;
-  uint64_t index_name;
-  T value;
-  PLATON_SERIALIZE(IndexKey<T>, (table_name)(index_name)(value))
-};
-
-template <typename T>
-struct NormalIndexKey {
-  uint64_t table_name;
-  uint64_t index_name;
-  T value;
+// unique index value -> sequence id
+template <Name::Raw TableName, Name::Raw IndexName, typename T>
+using IndexKey = PrefixedKey<KeyPrefix<TableName, IndexName>, T>;
 
-  // section number
-  uint64_t serial;
-
-  PLATON_SERIALIZE(NormalIndexKey, (table_name)(index_name)(value)(serial))
-};
+// normal index value and section number -> sequence ids
+template <Name::Raw TableName, Name::Raw IndexName, typename T>
+using NormalIndexKey =
+    PrefixedKey<KeyPrefix<TableName, IndexName>, T, uint64_t>;
 
 struct NormalIndexValue {
   constexpr static size_t MAXSIZE = 30;
@@ -44,14 +36,69 @@ struct NormalIndexValue {
 
 struct IndexType {
   struct UniqueIndex {};
+  // unique index that stores the row itself under its key, at most one. A
+  // find on it is one read and each row is written once. The seq keeps only
+  // the primary key, so secondary indexes and iteration read it first: one
+  // read per row more than with a UniqueIndex.
+  struct PrimaryIndex {};
   struct NormalIndex {};
+  // kept in key order by a B+-tree of at most NodeSize entries per node
+  template <size_t NodeSize = 32>
+  struct OrderedIndex {};
+};
+
+template <typename IndexTypeName>
+struct ordered_node_size : std::integral_constant<size_t, 0> {};
+
+template <size_t NodeSize>
+struct ordered_node_size<IndexType::OrderedIndex<NodeSize>>
+    : std::integral_constant<size_t, NodeSize> {};
+
+// the tree of the indexes that are not ordered
+struct NoTree {
+  struct Cursor {
+    bool operator==(const Cursor &) const { return true; }
+  };
+};
+
+// member function whose value a covering index keeps with its entries
+template <class Class, typename Type,
+          Type (Class::*PtrToMemberFunction)() const>
+struct ProjectMemberFun {
+  typedef typename std::decay<Type>::type ResultType;
+
+  ResultType operator()(const Class &x) const {
+    return (x.*PtrToMemberFunction)();
+  }
 };
 
-template <Name::Raw IndexSeq, typename Extractor>
+// the projected values of a covering index, in the declared order
+template <typename... Projections>
+struct Projected {
+  static constexpr size_t kSize = sizeof...(Projections);
+
+  typedef std::tuple<typename Projections::ResultType...> ValuesType;
+
+  template <typename Class>
+  static ValuesType extract(const Class &obj) {
+    return ValuesType(Projections()(obj)...);
+  }
+};
+
+/**
+ * @brief Index declaration, a unique index declared with projections covers
+ * them: their values are stored with the index entry and read without the row.
+ *
+ * @tparam IndexSeq Index name
+ * @tparam Extractor Index key extractor, IndexMemberFun
+ * @tparam Projections Covered member functions, ProjectMemberFun
+ */
+template <Name::Raw IndexSeq, typename Extractor, typename... Projections>
 struct IndexedBy {
   enum Constants { IndexName = static_cast<uint64_t>(IndexSeq) };
   //  static constexpr const char* IndexName() { return "Name"; }
   typedef Extractor SecondaryExtractorType;
+  typedef Projected<Projections...> ProjectionType;
 };
 
 template <class Class, typename Type,
@@ -77,132 +124,168 @@ struct IndexMemberFun {
 };
 
 // sequence id and T data
-struct MultiDBKey {
-  uint64_t table_name;
-  uint64_t seq;
-  PLATON_SERIALIZE(MultiDBKey, (table_name)(seq))
-};
+template <Name::Raw TableName>
+using MultiDBKey = PrefixedKey<KeyPrefix<TableName>, uint64_t>;
 
-template <typename T>
-void set_state_db(uint64_t table_name, uint64_t seq, const T &value) {
-  MultiDBKey key = {.table_name = table_name, .seq = seq};
+template <Name::Raw TableName, typename T>
+void set_state_db(uint64_t seq, const T &value) {
+  MultiDBKey<TableName> key(seq);
   set_state(key, value);
 }
 
-template <typename T>
-void get_state_db(uint64_t table_name, uint64_t seq, T &value) {
-  MultiDBKey key = {.table_name = table_name, .seq = seq};
+template <Name::Raw TableName, typename T>
+void get_state_db(uint64_t seq, T &value) {
+  MultiDBKey<TableName> key(seq);
   get_state(key, value);
 }
 
-bool has_state_db(uint64_t table_name, uint64_t seq) {
-  MultiDBKey key = {.table_name = table_name, .seq = seq};
+template <Name::Raw TableName>
+bool has_state_db(uint64_t seq) {
+  MultiDBKey<TableName> key(seq);
   return has_state(key);
 }
 
-void delete_state_db(uint64_t table_name, uint64_t seq) {
-  MultiDBKey key = {.table_name = table_name, .seq = seq};
+template <Name::Raw TableName>
+void delete_state_db(uint64_t seq) {
+  MultiDBKey<TableName> key(seq);
   del_state(key);
 }
 
+// live sequence id -> previous and next live sequence ids
+template <Name::Raw TableName>
+using SeqLinkKey = PrefixedKey<KeyPrefix<TableName, "$links"_n>, uint64_t>;
+
+struct SeqLink {
+  uint64_t previous;
+  uint64_t next;
+
+  PLATON_SERIALIZE(SeqLink, (previous)(next));
+};
+
+// head of the circular list of live sequence ids
+constexpr uint64_t kSeqListHead = UINT64_MAX;
+
+// sequence ids below it are linked, present while a table written before the
+// list existed is being linked
+template <Name::Raw TableName>
+using SeqLinkCursorKey = PrefixedKey<KeyPrefix<TableName, "$linking"_n>>;
+
+// sequence ids probed and linked per MultiIndex object while linking a table
+constexpr uint64_t kSeqLinkBatch = 64;
+
 // unique index and squence id
-template <typename T>
-void set_index_db(uint64_t table_name, uint64_t index_name, uint64_t seq,
-                  const T &value) {
+template <Name::Raw TableName, Name::Raw IndexName, typename T>
+void set_index_db(uint64_t seq, const T &value) {
   // todo find value form Extractor, create index sequence
-  IndexKey<T> key = {
-      .table_name = table_name, .index_name = index_name, .value = value};
+  IndexKey<TableName, IndexName, T> key(value);
 
   set_state(key, seq);
 }
 
-template <typename T>
-bool has_index_db(uint64_t table_name, uint64_t index_name, const T &value) {
-  IndexKey<T> key = {
-      .table_name = table_name, .index_name = index_name, .value = value};
+template <Name::Raw TableName, Name::Raw IndexName, typename T>
+bool has_index_db(const T &value) {
+  IndexKey<TableName, IndexName, T> key(value);
   return has_state(key);
 }
 
-template <typename T, typename R>
-R get_index_db(uint64_t table_name, uint64_t index_name, const T &value) {
+template <Name::Raw TableName, Name::Raw IndexName, typename T, typename R>
+R get_index_db(const T &value) {
   R result;
-  IndexKey<T> key = {
-      .table_name = table_name, .index_name = index_name, .value = value};
+  IndexKey<TableName, IndexName, T> key(value);
   get_state(key, result);
   return result;
 }
 
-template <typename T>
-void delete_index_db(uint64_t table_name, uint64_t index_name, const T &value) {
-  IndexKey<T> key = {
-      .table_name = table_name, .index_name = index_name, .value = value};
+template <Name::Raw TableName, Name::Raw IndexName, typename T>
+void delete_index_db(const T &value) {
+  IndexKey<TableName, IndexName, T> key(value);
   del_state(key);
 }
 
+// primary index value -> sequence id and row
 template <typename T>
-bool check_unique(uint64_t table_name, uint64_t index_name, const T &value) {
-  IndexKey<T> key = {
-      .table_name = table_name, .index_name = index_name, .value = value};
+struct PrimaryRow {
+  uint64_t seq;
+  T row;
+
+  PLATON_SERIALIZE(PrimaryRow, (seq)(row));
+};
+
+template <Name::Raw TableName, Name::Raw IndexName, typename K, typename T>
+void set_primary_db(const K &value, uint64_t seq, const T &row) {
+  IndexKey<TableName, IndexName, K> key(value);
+  set_state(key, PrimaryRow<T>{seq, row});
+}
+
+template <Name::Raw TableName, Name::Raw IndexName, typename K, typename T>
+bool get_primary_db(const K &value, PrimaryRow<T> &result) {
+  IndexKey<TableName, IndexName, K> key(value);
+  return 0 != get_state(key, result);
+}
+
+// covering unique index value -> sequence id and projected values
+template <typename V>
+struct CoveredEntry {
+  uint64_t seq;
+  V values;
+
+  PLATON_SERIALIZE(CoveredEntry, (seq)(values));
+};
+
+template <Name::Raw TableName, Name::Raw IndexName, typename K, typename V>
+void set_covered_db(const K &value, uint64_t seq, const V &values) {
+  IndexKey<TableName, IndexName, K> key(value);
+  set_state(key, CoveredEntry<V>{seq, values});
+}
+
+template <Name::Raw TableName, Name::Raw IndexName, typename K, typename V>
+bool get_covered_db(const K &value, CoveredEntry<V> &result) {
+  IndexKey<TableName, IndexName, K> key(value);
+  return 0 != get_state(key, result);
+}
+
+template <Name::Raw TableName, Name::Raw IndexName, typename T>
+bool check_unique(const T &value) {
+  IndexKey<TableName, IndexName, T> key(value);
   return has_state(key);
 }
 
 // normal index key and previous sequence, next sequence
 constexpr uint64_t HEADSERIAL = 0;
 
-template <typename T>
-bool has_normal_index_db(uint64_t table_name, uint64_t index_name,
-                         const T &value) {
-  NormalIndexKey<T> key = {.table_name = table_name,
-                           .index_name = index_name,
-                           .value = value,
-                           .serial = HEADSERIAL};
+template <Name::Raw TableName, Name::Raw IndexName, typename T>
+bool has_normal_index_db(const T &value) {
+  NormalIndexKey<TableName, IndexName, T> key(value, HEADSERIAL);
   NormalIndexValue result;
   size_t len = get_state(key, result);
   if (0 == len) return false;
   return true;
 }
 
-template <typename T>
-NormalIndexValue get_normal_index_one_db(uint64_t table_name,
-                                         uint64_t index_name, const T &value,
-                                         uint64_t serial) {
-  NormalIndexKey<T> key = {.table_name = table_name,
-                           .index_name = index_name,
-                           .value = value,
-                           .serial = serial};
+template <Name::Raw TableName, Name::Raw IndexName, typename T>
+NormalIndexValue get_normal_index_one_db(const T &value, uint64_t serial) {
+  NormalIndexKey<TableName, IndexName, T> key(value, serial);
   NormalIndexValue result;
   get_state(key, result);
   return result;
 }
 
-template <typename T>
-void set_normal_index_one_db(uint64_t table_name, uint64_t index_name,
-                             const T &value, uint64_t serial,
+template <Name::Raw TableName, Name::Raw IndexName, typename T>
+void set_normal_index_one_db(const T &value, uint64_t serial,
                              const NormalIndexValue &index_value) {
-  NormalIndexKey<T> key = {.table_name = table_name,
-                           .index_name = index_name,
-                           .value = value,
-                           .serial = serial};
+  NormalIndexKey<TableName, IndexName, T> key(value, serial);
   set_state(key, index_value);
 }
 
-template <typename T>
-void delete_normal_index_one_db(uint64_t table_name, uint64_t index_name,
-                                const T &value, uint64_t serial) {
-  NormalIndexKey<T> key = {.table_name = table_name,
-                           .index_name = index_name,
-                           .value = value,
-                           .serial = serial};
+template <Name::Raw TableName, Name::Raw IndexName, typename T>
+void delete_normal_index_one_db(const T &value, uint64_t serial) {
+  NormalIndexKey<TableName, IndexName, T> key(value, serial);
   del_state(key);
 }
 
-template <typename T>
-void append_normal_index_one_db(uint64_t table_name, uint64_t index_name,
-                                uint64_t seq, const T &value) {
-  NormalIndexKey<T> key = {.table_name = table_name,
-                           .index_name = index_name,
-                           .value = value,
-                           .serial = HEADSERIAL};
+template <Name::Raw TableName, Name::Raw IndexName, typename T>
+void append_normal_index_one_db(uint64_t seq, const T &value) {
+  NormalIndexKey<TableName, IndexName, T> key(value, HEADSERIAL);
   NormalIndexValue head;
   size_t len = get_state(key, head);
 
@@ -211,7 +294,7 @@ void append_normal_index_one_db(uint64_t table_name, uint64_t index_name,
     head.vect_seq = std::vector<uint64_t>{seq};
     head.previous = HEADSERIAL;
     head.next = HEADSERIAL;
-    set_normal_index_one_db(table_name, index_name, value, HEADSERIAL, head);
+    set_normal_index_one_db<TableName, IndexName>(value, HEADSERIAL, head);
     return;
   }
 
@@ -219,16 +302,16 @@ void append_normal_index_one_db(uint64_t table_name, uint64_t index_name,
   if (HEADSERIAL == head.previous && HEADSERIAL == head.next) {
     if (head.vect_seq.size() < NormalIndexValue::MAXSIZE) {
       head.vect_seq.push_back(seq);
-      set_normal_index_one_db(table_name, index_name, value, HEADSERIAL, head);
+      set_normal_index_one_db<TableName, IndexName>(value, HEADSERIAL, head);
     } else {
       NormalIndexValue new_value = {
           .previous = HEADSERIAL, .vect_seq = {seq}, .next = HEADSERIAL};
       uint64_t new_serial = HEADSERIAL + 1;
-      set_normal_index_one_db(table_name, index_name, value, new_serial,
-                              new_value);
+      set_normal_index_one_db<TableName, IndexName>(value, new_serial,
+                                                    new_value);
       head.previous = new_serial;
       head.next = new_serial;
-      set_normal_index_one_db(table_name, index_name, value, HEADSERIAL, head);
+      set_normal_index_one_db<TableName, IndexName>(value, HEADSERIAL, head);
     }
     return;
   }
@@ -237,33 +320,102 @@ void append_normal_index_one_db(uint64_t table_name, uint64_t index_name,
   if (HEADSERIAL != head.previous) {
     uint64_t last_serial = head.previous;
     NormalIndexValue old_last =
-        get_normal_index_one_db(table_name, index_name, value, last_serial);
+        get_normal_index_one_db<TableName, IndexName>(value, last_serial);
     if (old_last.vect_seq.size() < NormalIndexValue::MAXSIZE) {
       old_last.vect_seq.push_back(seq);
-      set_normal_index_one_db(table_name, index_name, value, last_serial,
-                              old_last);
+      set_normal_index_one_db<TableName, IndexName>(value, last_serial,
+                                                    old_last);
     } else {
       NormalIndexValue new_value = {
           .previous = last_serial, .vect_seq = {seq}, .next = HEADSERIAL};
       uint64_t new_serial = last_serial + 1;
-      set_normal_index_one_db(table_name, index_name, value, new_serial,
-                              new_value);
+      set_normal_index_one_db<TableName, IndexName>(value, new_serial,
+                                                    new_value);
       old_last.next = new_serial;
-      set_normal_index_one_db(table_name, index_name, value, last_serial,
-                              old_last);
+      set_normal_index_one_db<TableName, IndexName>(value, last_serial,
+                                                    old_last);
       head.previous = new_serial;
-      set_normal_index_one_db(table_name, index_name, value, HEADSERIAL, head);
+      set_normal_index_one_db<TableName, IndexName>(value, HEADSERIAL, head);
     }
   }
 }
 
-template <typename T>
-void delete_normal_index_db(uint64_t table_name, uint64_t index_name,
-                            uint64_t seq, const T &value) {
-  NormalIndexKey<T> key = {.table_name = table_name,
-                           .index_name = index_name,
-                           .value = value,
-                           .serial = HEADSERIAL};
+// add a sequence id that may be lower than the ones in the list. It goes in
+// order into the section that covers it, or into the last section when that
+// one is full, so each section stays sorted but the sections may overlap.
+template <Name::Raw TableName, Name::Raw IndexName, typename T>
+void insert_normal_index_db(uint64_t seq, const T &value) {
+  NormalIndexKey<TableName, IndexName, T> key(value, HEADSERIAL);
+  NormalIndexValue head;
+  size_t len = get_state(key, head);
+  uint64_t last_serial = head.previous;
+  NormalIndexValue last;
+  if (0 != len) {
+    last = last_serial == HEADSERIAL
+               ? head
+               : get_normal_index_one_db<TableName, IndexName>(value,
+                                                               last_serial);
+  }
+  if (0 == len || last.vect_seq.back() < seq) {
+    append_normal_index_one_db<TableName, IndexName>(seq, value);
+    return;
+  }
+
+  auto insert_sorted = [&](uint64_t serial, NormalIndexValue &section) {
+    auto iter = std::lower_bound(section.vect_seq.begin(),
+                                 section.vect_seq.end(), seq);
+    if (section.vect_seq.end() == iter || *iter != seq) {
+      section.vect_seq.insert(iter, seq);
+      set_normal_index_one_db<TableName, IndexName>(value, serial, section);
+    }
+  };
+
+  // the first section whose last sequence id is not lower than seq, the
+  // sections are sorted by serial and some serials may be free
+  uint64_t found = last_serial;
+  uint64_t begin_serial = HEADSERIAL;
+  uint64_t end_serial = last_serial;
+  while (begin_serial < end_serial) {
+    uint64_t mid_serial = begin_serial + (end_serial - begin_serial) / 2;
+    uint64_t serial = mid_serial;
+    NormalIndexValue one_value;
+    for (; serial < end_serial; ++serial) {
+      NormalIndexKey<TableName, IndexName, T> one_key(value, serial);
+      if (0 != get_state(one_key, one_value)) break;
+    }
+    if (serial == end_serial) {
+      end_serial = mid_serial;
+    } else if (one_value.vect_seq.back() >= seq) {
+      found = serial;
+      end_serial = mid_serial;
+    } else {
+      begin_serial = serial + 1;
+    }
+  }
+
+  // a full section is not split or shifted, that would rewrite the sections
+  // after it, the sequence id goes to the last section instead
+  NormalIndexValue section =
+      found == last_serial
+          ? last
+          : get_normal_index_one_db<TableName, IndexName>(value, found);
+  if (std::binary_search(section.vect_seq.begin(), section.vect_seq.end(),
+                         seq)) {
+    return;
+  }
+  if (section.vect_seq.size() < NormalIndexValue::MAXSIZE) {
+    insert_sorted(found, section);
+  } else if (found != last_serial &&
+             last.vect_seq.size() < NormalIndexValue::MAXSIZE) {
+    insert_sorted(last_serial, last);
+  } else {
+    append_normal_index_one_db<TableName, IndexName>(seq, value);
+  }
+}
+
+template <Name::Raw TableName, Name::Raw IndexName, typename T>
+void delete_normal_index_db(uint64_t seq, const T &value) {
+  NormalIndexKey<TableName, IndexName, T> key(value, HEADSERIAL);
   NormalIndexValue head;
   size_t len = get_state(key, head);
   if (0 == len) return;
@@ -275,9 +427,9 @@ void delete_normal_index_db(uint64_t table_name, uint64_t index_name,
     if (head.vect_seq.end() == iter || *iter != seq) return;
     head.vect_seq.erase(iter);
     if (0 == head.vect_seq.size()) {
-      delete_normal_index_one_db(table_name, index_name, value, HEADSERIAL);
+      delete_normal_index_one_db<TableName, IndexName>(value, HEADSERIAL);
     } else {
-      set_normal_index_one_db(table_name, index_name, value, HEADSERIAL, head);
+      set_normal_index_one_db<TableName, IndexName>(value, HEADSERIAL, head);
     }
     return;
   }
@@ -286,10 +438,7 @@ void delete_normal_index_db(uint64_t table_name, uint64_t index_name,
   auto next_valid = [&](uint64_t serial, bool &bfind) {
     NormalIndexValue one_value;
     while (true) {
-      NormalIndexKey<T> key = {.table_name = table_name,
-                               .index_name = index_name,
-                               .value = value,
-                               .serial = serial};
+      NormalIndexKey<TableName, IndexName, T> key(value, serial);
       size_t len = get_state(key, one_value);
       if (0 != len) {
         bfind = true;
@@ -307,10 +456,7 @@ void delete_normal_index_db(uint64_t table_name, uint64_t index_name,
   auto previous_valid = [&](uint64_t serial, bool &bfind) {
     NormalIndexValue one_value;
     while (true) {
-      NormalIndexKey<T> key = {.table_name = table_name,
-                               .index_name = index_name,
-                               .value = value,
-                               .serial = serial};
+      NormalIndexKey<TableName, IndexName, T> key(value, serial);
       size_t len = get_state(key, one_value);
       if (0 != len) {
         bfind = true;
@@ -328,100 +474,118 @@ void delete_normal_index_db(uint64_t table_name, uint64_t index_name,
   uint64_t begin_serial = HEADSERIAL;
   uint64_t end_serial = head.previous;
   bool find_valid = false;
+  uint64_t real_serial = HEADSERIAL;
+  NormalIndexValue real_value;
+  bool found = false;
+  auto find_in = [&](NormalIndexValue &one_value) {
+    auto iter = std::lower_bound(one_value.vect_seq.begin(),
+                                 one_value.vect_seq.end(), seq);
+    if (one_value.vect_seq.end() == iter || *iter != seq) return false;
+    one_value.vect_seq.erase(iter);
+    return true;
+  };
 
   while (begin_serial <= end_serial) {
     uint64_t mid_serial = (begin_serial + end_serial) / 2;
 
     auto next_valid_pair = next_valid(mid_serial, find_valid);
-    if (!find_valid) return;
+    if (!find_valid) break;
 
     if (next_valid_pair.second.vect_seq.back() < seq) {
       begin_serial = next_valid(next_valid_pair.first + 1, find_valid).first;
-      if (!find_valid) return;
+      if (!find_valid) break;
     } else if (next_valid_pair.second.vect_seq.front() > seq) {
       if (mid_serial == next_valid_pair.first) mid_serial -= 1;
       end_serial = previous_valid(mid_serial, find_valid).first;
-      if (!find_valid) return;
+      if (!find_valid) break;
     } else {
-      uint64_t real_serial = next_valid_pair.first;
-      NormalIndexValue real_value = next_valid_pair.second;
-      auto iter = std::lower_bound(real_value.vect_seq.begin(),
-                                   real_value.vect_seq.end(), seq);
-      if (real_value.vect_seq.end() == iter || *iter != seq) return;
-      real_value.vect_seq.erase(iter);
-      if (0 == real_value.vect_seq.size()) {
-        uint64_t previous = real_value.previous;
-        uint64_t next = real_value.next;
-        delete_normal_index_one_db(table_name, index_name, value, real_serial);
-
-        // head
-        if (HEADSERIAL == real_serial) {
-          // only one
-          if (HEADSERIAL == previous && HEADSERIAL == next) return;
-
-          // only two
-          if (previous == next) {
-            NormalIndexValue next_value =
-                get_normal_index_one_db(table_name, index_name, value, next);
-            delete_normal_index_one_db(table_name, index_name, value, next);
-            set_normal_index_one_db(table_name, index_name, value, HEADSERIAL,
-                                    next_value);
-            return;
-          }
+      real_serial = next_valid_pair.first;
+      real_value = next_valid_pair.second;
+      found = find_in(real_value);
+      break;
+    }
+  }
 
-          // more than two
-          NormalIndexValue next_value =
-              get_normal_index_one_db(table_name, index_name, value, next);
-          next_value.previous = previous;
-          delete_normal_index_one_db(table_name, index_name, value, next);
-          set_normal_index_one_db(table_name, index_name, value, HEADSERIAL,
-                                  next_value);
-          uint64_t new_next = next_value.next;
-          NormalIndexValue new_next_value =
-              get_normal_index_one_db(table_name, index_name, value, new_next);
-          new_next_value.previous = HEADSERIAL;
-          set_normal_index_one_db(table_name, index_name, value, new_next,
-                                  new_next_value);
-          return;
-        }
+  // a sequence id inserted out of order sits in the last section, or in one
+  // the search did not reach when sections overlap, walk the list
+  if (!found) {
+    real_serial = HEADSERIAL;
+    real_value = head;
+    while (!(found = find_in(real_value)) && HEADSERIAL != real_value.next) {
+      real_serial = real_value.next;
+      real_value =
+          get_normal_index_one_db<TableName, IndexName>(value, real_serial);
+    }
+    if (!found) return;
+  }
 
-        // only two
-        if (HEADSERIAL == previous && HEADSERIAL == next) {
-          head.previous = HEADSERIAL;
-          head.next = HEADSERIAL;
-          set_normal_index_one_db(table_name, index_name, value, HEADSERIAL,
-                                  head);
-          return;
-        }
+  if (0 == real_value.vect_seq.size()) {
+    uint64_t previous = real_value.previous;
+    uint64_t next = real_value.next;
+    delete_normal_index_one_db<TableName, IndexName>(value, real_serial);
+
+    // head
+    if (HEADSERIAL == real_serial) {
+      // only one
+      if (HEADSERIAL == previous && HEADSERIAL == next) return;
 
-        // more than two
-        NormalIndexValue previous_value =
-            get_normal_index_one_db(table_name, index_name, value, previous);
-        previous_value.next = next;
-        set_normal_index_one_db(table_name, index_name, value, previous,
-                                previous_value);
+      // only two
+      if (previous == next) {
         NormalIndexValue next_value =
-            get_normal_index_one_db(table_name, index_name, value, next);
-        next_value.previous = previous;
-        set_normal_index_one_db(table_name, index_name, value, next,
-                                next_value);
-      } else {
-        set_normal_index_one_db(table_name, index_name, value, real_serial,
-                                real_value);
+            get_normal_index_one_db<TableName, IndexName>(value, next);
+        delete_normal_index_one_db<TableName, IndexName>(value, next);
+        set_normal_index_one_db<TableName, IndexName>(value, HEADSERIAL,
+                                                      next_value);
+        return;
       }
-      break;
+
+      // more than two
+      NormalIndexValue next_value =
+          get_normal_index_one_db<TableName, IndexName>(value, next);
+      next_value.previous = previous;
+      delete_normal_index_one_db<TableName, IndexName>(value, next);
+      set_normal_index_one_db<TableName, IndexName>(value, HEADSERIAL,
+                                                    next_value);
+      uint64_t new_next = next_value.next;
+      NormalIndexValue new_next_value =
+          get_normal_index_one_db<TableName, IndexName>(value, new_next);
+      new_next_value.previous = HEADSERIAL;
+      set_normal_index_one_db<TableName, IndexName>(value, new_next,
+                                                    new_next_value);
+      return;
+    }
+
+    // only two
+    if (HEADSERIAL == previous && HEADSERIAL == next) {
+      head.previous = HEADSERIAL;
+      head.next = HEADSERIAL;
+      set_normal_index_one_db<TableName, IndexName>(value, HEADSERIAL, head);
+      return;
     }
+
+    // more than two
+    NormalIndexValue previous_value =
+        get_normal_index_one_db<TableName, IndexName>(value, previous);
+    previous_value.next = next;
+    set_normal_index_one_db<TableName, IndexName>(value, previous,
+                                                  previous_value);
+    NormalIndexValue next_value =
+        get_normal_index_one_db<TableName, IndexName>(value, next);
+    next_value.previous = previous;
+    set_normal_index_one_db<TableName, IndexName>(value, next, next_value);
+  } else {
+    set_normal_index_one_db<TableName, IndexName>(value, real_serial,
+                                                  real_value);
   }
 }
 
-template <typename T>
-size_t get_normal_index_count_db(uint64_t table_name, uint64_t index_name,
-                                 const T &value) {
+template <Name::Raw TableName, Name::Raw IndexName, typename T>
+size_t get_normal_index_count_db(const T &value) {
   NormalIndexValue head =
-      get_normal_index_one_db(table_name, index_name, value, HEADSERIAL);
+      get_normal_index_one_db<TableName, IndexName>(value, HEADSERIAL);
   size_t count = head.vect_seq.size();
   while (HEADSERIAL != head.next) {
-    head = get_normal_index_one_db(table_name, index_name, value, head.next);
+    head = get_normal_index_one_db<TableName, IndexName>(value, head.next);
     count += head.vect_seq.size();
   }
 
@@ -464,12 +628,13 @@ class MultiIndex {
                 "multi_index only supports a maximum of 16 secondary indices");
 
   template <Name::Raw IndexName, typename Extractor, uint64_t Number,
-            typename IndexTypeName>
+            typename IndexTypeName, typename Projection = Projected<>>
   struct Index {
    public:
     typedef Extractor SecondaryExtractorType;
     typedef typename std::decay<decltype(Extractor()(nullptr))>::type
         SecondaryKeyType;
+    typedef typename Projection::ValuesType ProjectedType;
 
     enum Constants {
       kTableName = static_cast<uint64_t>(TableName),
@@ -478,9 +643,33 @@ class MultiIndex {
     };
 
     static constexpr bool unique() {
-      return std::is_same<IndexTypeName, IndexType::UniqueIndex>::value;
+      return std::is_same<IndexTypeName, IndexType::UniqueIndex>::value ||
+             primary();
     }
 
+    static constexpr bool primary() {
+      return std::is_same<IndexTypeName, IndexType::PrimaryIndex>::value;
+    }
+
+    static constexpr bool ordered() {
+      return ordered_node_size<IndexTypeName>::value != 0;
+    }
+
+    static constexpr bool covering() { return Projection::kSize != 0; }
+
+    static_assert(
+        Projection::kSize == 0 ||
+            std::is_same<IndexTypeName, IndexType::UniqueIndex>::value,
+        "only a unique index can cover projections");
+
+    typedef typename std::conditional<
+        ordered_node_size<IndexTypeName>::value != 0,
+        OrderedTree<TableName, IndexName, SecondaryKeyType,
+                    ordered_node_size<IndexTypeName>::value>,
+        NoTree>::type Tree;
+
+    static constexpr Name::Raw kIndexRaw = IndexName;
+
     static constexpr uint64_t index_name() { return kIndexName; }
     static constexpr uint64_t table_name() { return kTableName; }
     static constexpr uint64_t index_number() { return kIndexNumber; }
@@ -489,6 +678,65 @@ class MultiIndex {
       return SecondaryExtractorType()(obj);
     }
 
+    static ProjectedType extract_projection(const T &obj) {
+      return Projection::extract(obj);
+    }
+
+    // the unique index entry of the row, with the projection if it covers one
+    static void set_unique_db(uint64_t seq, const T &obj) {
+      if constexpr (covering()) {
+        set_covered_db<TableName, IndexName>(extract_secondary_key(obj), seq,
+                                             extract_projection(obj));
+      } else {
+        set_index_db<TableName, IndexName>(seq, extract_secondary_key(obj));
+      }
+    }
+
+    // sequence id of the unique index entry, false if there is none
+    template <typename KEY>
+    static bool get_unique_db(const KEY &key, uint64_t &seq) {
+      if constexpr (covering()) {
+        CoveredEntry<ProjectedType> entry;
+        if (!get_covered_db<TableName, IndexName>(SecondaryKeyType(key),
+                                                  entry))
+          return false;
+        seq = entry.seq;
+      } else {
+        if (!has_index_db<TableName, IndexName>(key)) return false;
+        seq = get_index_db<TableName, IndexName, KEY, uint64_t>(key);
+      }
+      return true;
+    }
+
+    /**
+     * @brief The projected values of the row whose key is @a key, read from
+     * the index entry alone, for a covering unique index
+     *
+     * @param key key of index
+     * @return std::pair<ProjectedType, bool> The values in the declared order,
+     * and whether the row exists
+     *
+     * Example:
+     *
+     * @code
+      MultiIndex<
+       "table"_n, Member,
+        IndexedBy<"index"_n,
+                  IndexMemberFun<Member, std::string, &Member::Name,
+                                 IndexType::UniqueIndex>,
+                  ProjectMemberFun<Member, uint8_t, &Member::Age>>>
+       member_table;
+      auto r = member_table.get_index<"index"_n>().project("alice");
+      if (r.second) uint8_t age = std::get<0>(r.first);
+     * @endcode
+     */
+    std::pair<ProjectedType, bool> project(const SecondaryKeyType &key) {
+      static_assert(covering(), "project needs a covering index");
+      CoveredEntry<ProjectedType> entry;
+      bool found = get_covered_db<TableName, IndexName>(key, entry);
+      return std::make_pair(std::move(entry.values), found);
+    }
+
     // iterator
     class const_iterator
         : public std::iterator<std::bidirectional_iterator_tag, const T> {
@@ -507,14 +755,14 @@ class MultiIndex {
 
       const T &operator*() const {
         NormalIndexValue index_value =
-            get_normal_index_one_db(table_name(), index_name(), key_, serial_);
+            get_normal_index_one_db<TableName, IndexName>(key_, serial_);
         uint64_t seq = index_value.vect_seq[num_];
         return static_cast<T &>(*multiIndex_->get_item_ptr(seq));
       }
 
       uint64_t get_seq() {
         NormalIndexValue index_value =
-            get_normal_index_one_db(table_name(), index_name(), key_, serial_);
+            get_normal_index_one_db<TableName, IndexName>(key_, serial_);
         return index_value.vect_seq[num_];
       }
 
@@ -522,7 +770,7 @@ class MultiIndex {
 
       const_iterator &operator++() {
         NormalIndexValue index_value =
-            get_normal_index_one_db(table_name(), index_name(), key_, serial_);
+            get_normal_index_one_db<TableName, IndexName>(key_, serial_);
         if (num_ == index_value.vect_seq.size() - 1) {
           serial_ = index_value.next;
           if (HEADSERIAL == serial_) {
@@ -544,20 +792,20 @@ class MultiIndex {
 
       const_iterator &operator--() {
         NormalIndexValue index_value =
-            get_normal_index_one_db(table_name(), index_name(), key_, serial_);
+            get_normal_index_one_db<TableName, IndexName>(key_, serial_);
         if (num_ == 0) {
           if (HEADSERIAL == serial_) {
             num_ = NormalIndexValue::MAXSIZE;
           } else {
             serial_ = index_value.previous;
-            index_value = get_normal_index_one_db(table_name(), index_name(),
-                                                  key_, serial_);
+            index_value =
+                get_normal_index_one_db<TableName, IndexName>(key_, serial_);
             num_ = index_value.vect_seq.size() - 1;
           }
         } else if (NormalIndexValue::MAXSIZE == num_ && HEADSERIAL == serial_) {
           serial_ = index_value.previous;
-          index_value = get_normal_index_one_db(table_name(), index_name(),
-                                                key_, serial_);
+          index_value =
+              get_normal_index_one_db<TableName, IndexName>(key_, serial_);
           num_ = index_value.vect_seq.size() - 1;
         } else {
           --num_;
@@ -585,6 +833,162 @@ class MultiIndex {
       friend class Index;
     };
 
+    // iterator of an ordered index, in key order. It stays valid when other
+    // rows are added or erased, an iterator of an erased row moves to the
+    // next row.
+    class ordered_iterator
+        : public std::iterator<std::bidirectional_iterator_tag, const T> {
+     public:
+      friend bool operator==(const ordered_iterator &a,
+                             const ordered_iterator &b) {
+        return a.multiIndex_ == b.multiIndex_ && a.cursor() == b.cursor();
+      }
+
+      friend bool operator!=(const ordered_iterator &a,
+                             const ordered_iterator &b) {
+        return !(a == b);
+      }
+
+      const T &operator*() const {
+        return static_cast<T &>(*multiIndex_->get_item_ptr(get_seq()));
+      }
+
+      const T *operator->() const { return &**this; }
+
+      uint64_t get_seq() const { return tree().seq(cursor()); }
+
+      // the index key, read without loading the row
+      const SecondaryKeyType &key() const { return tree().key(cursor()); }
+
+      ordered_iterator &operator++() {
+        tree().next(cursor());
+        remember();
+        return *this;
+      }
+
+      ordered_iterator operator++(int) {
+        auto result = *this;
+        ++(*this);
+        return result;
+      }
+
+      ordered_iterator &operator--() {
+        tree().previous(cursor());
+        remember();
+        return *this;
+      }
+
+      ordered_iterator operator--(int) {
+        auto result = *this;
+        --(*this);
+        return result;
+      }
+
+     private:
+      typedef typename Tree::Cursor Cursor;
+
+      ordered_iterator(MultiIndex *mi, Cursor cursor)
+          : multiIndex_(mi), cursor_(cursor) {
+        remember();
+      }
+
+      Tree &tree() const { return hana::at_c<Number>(multiIndex_->trees_); }
+
+      // the cursor, found again from the entry if the tree changed since
+      Cursor &cursor() const {
+        if (version_ != tree().version()) {
+          if (0 != cursor_.node) cursor_ = tree().seek(key_, seq_);
+          version_ = tree().version();
+        }
+        return cursor_;
+      }
+
+      void remember() {
+        version_ = tree().version();
+        if (0 == cursor_.node) return;
+        key_ = tree().key(cursor_);
+        seq_ = tree().seq(cursor_);
+      }
+
+      MultiIndex *multiIndex_;
+      mutable Cursor cursor_;
+      mutable uint64_t version_ = 0;
+      SecondaryKeyType key_;
+      uint64_t seq_ = 0;
+
+      friend class Index;
+    };
+
+    /**
+     * @brief Iterator of the first row whose key is not less than @a key, for
+     * an ordered index
+     *
+     * @param key key of index
+     * @return ordered_iterator
+     *
+     * Example:
+     *
+     * @code
+      MultiIndex<
+       "table"_n, Member,
+        IndexedBy<"index"_n, IndexMemberFun<Member, std::string, &Member::Name,
+                                           IndexType::UniqueIndex>>,
+       IndexedBy<"age"_n, IndexMemberFun<Member, uint8_t, &Member::Age,
+                                         IndexType::OrderedIndex<>>>>
+       member_table;
+      auto index = member_table.get_index<"age"_n>();
+      for (auto it = index.lower_bound(18); it != index.end(); ++it) {}
+     * @endcode
+     */
+    ordered_iterator lower_bound(const SecondaryKeyType &key) {
+      static_assert(ordered(), "lower_bound needs an ordered index");
+      return ordered_iterator(multidx_, tree().lower_bound(key));
+    }
+
+    /**
+     * @brief Iterator of the first row whose key is greater than @a key, for
+     * an ordered index
+     *
+     * @param key key of index
+     * @return ordered_iterator
+     */
+    ordered_iterator upper_bound(const SecondaryKeyType &key) {
+      static_assert(ordered(), "upper_bound needs an ordered index");
+      return ordered_iterator(multidx_, tree().upper_bound(key));
+    }
+
+    /**
+     * @brief Rows whose key equals @a key, for an ordered index
+     *
+     * @param key key of index
+     * @return std::pair<ordered_iterator, ordered_iterator> The lower and the
+     * upper bound
+     */
+    std::pair<ordered_iterator, ordered_iterator> equal_range(
+        const SecondaryKeyType &key) {
+      return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+
+    /**
+     * @brief Iterator of the row with the smallest key, for an ordered index
+     *
+     * @return ordered_iterator
+     */
+    ordered_iterator begin() {
+      static_assert(ordered(), "begin needs an ordered index");
+      return ordered_iterator(multidx_, tree().first());
+    }
+
+    /**
+     * @brief End iterator of an ordered index
+     *
+     * @return ordered_iterator
+     */
+    ordered_iterator end() {
+      static_assert(ordered(), "end needs an ordered index");
+      return ordered_iterator(multidx_, typename Tree::Cursor());
+    }
+
     /**
       * @brief Iterator start position
       *
@@ -616,10 +1020,10 @@ class MultiIndex {
       * @endcode
       */
     const_iterator cbegin(const SecondaryKeyType &value) {
-      NormalIndexKey<SecondaryKeyType> key = {.table_name = table_name(),
-                                              .index_name = index_name(),
-                                              .value = value,
-                                              .serial = HEADSERIAL};
+      static_assert(!ordered(), "use lower_bound on an ordered index");
+      static_assert(!unique(), "use find on a unique index");
+      NormalIndexKey<TableName, IndexName, SecondaryKeyType> key(value,
+                                                                 HEADSERIAL);
       NormalIndexValue result;
       size_t len = get_state(key, result);
       if (0 == len) return cend(value);
@@ -657,16 +1061,20 @@ class MultiIndex {
       * @endcode
       */
     const_iterator cend(const SecondaryKeyType &key) {
+      static_assert(!ordered(), "use upper_bound on an ordered index");
+      static_assert(!unique(), "use find on a unique index");
       return const_iterator(multidx_, key, HEADSERIAL,
                             NormalIndexValue::MAXSIZE);
     }
 
     /**
-     * @brief Modify data based on iterator, but cannot modify all index-related
-     * fields .
+     * @brief Modify data based on iterator. Only the index entries whose key
+     * changed are rewritten, the row keeps its sequence id.
      *
      * @param position position of iterator
      * @param constructor lambda function that updates the target object
+     * @return true if the row is modified, false if a changed unique index
+     * key is taken by another row, nothing is changed then
      *
      * Example:
      *
@@ -694,36 +1102,13 @@ class MultiIndex {
      * @endcode
      */
     template <typename Lambda>
-    void modify(const_iterator position, Lambda &&constructor) {
-      auto item = std::make_shared<Item>(multidx_, [&](auto &i) {
-        T &obj = static_cast<T &>(i);
-        obj = *position;
-        constructor(obj);
-        i.$seq = position.get_seq();
-      });
-
-      T &new_obj = static_cast<T &>(*item);
-      const T &old_obj = static_cast<const T &>(*position);
-      bool enable = true;
-
-      // update index key is illegal operation
-      hana::any_of(multidx_->indices_, [&](auto &idx) {
-        typedef typename decltype(+hana::at_c<0>(idx))::type IndexType;
-        // check index key
-        if (IndexType::extract_secondary_key(old_obj) !=
-            IndexType::extract_secondary_key(new_obj)) {
-          enable = false;
-          return true;
-        }
-        return false;
-      });
+    bool modify(const_iterator position, Lambda &&constructor) {
+      return multidx_->modify_seq(position.get_seq(), constructor);
+    }
 
-      if (enable) {
-        // update
-        set_state_db(static_cast<uint64_t>(TableName), position.get_seq(),
-                     new_obj);
-        multidx_->seq2item_[item->$seq] = item;
-      }
+    template <typename Lambda>
+    bool modify(ordered_iterator position, Lambda &&constructor) {
+      return multidx_->modify_seq(position.get_seq(), constructor);
     }
 
     /**
@@ -757,30 +1142,19 @@ class MultiIndex {
      * @endcode
      */
     void erase(const_iterator position) {
-      uint64_t seq = position.get_seq();
-      hana::for_each(multidx_->indices_, [&](auto &idx) {
-        typedef typename decltype(+hana::at_c<0>(idx))::type IndexType;
-        if (IndexType::unique()) {
-          delete_index_db<typename IndexType::SecondaryKeyType>(
-              IndexType::table_name(), IndexType::index_name(),
-              IndexType::extract_secondary_key(*position));
-        } else {
-          delete_normal_index_db<typename IndexType::SecondaryKeyType>(
-              IndexType::table_name(), IndexType::index_name(), seq,
-              IndexType::extract_secondary_key(*position));
-        }
-      });
-
-      // delete key
-      delete_state_db(static_cast<uint64_t>(TableName), seq);
+      multidx_->erase_seq(position.get_seq());
+    }
 
-      // delete
-      multidx_->seq2item_.erase(seq);
+    void erase(ordered_iterator position) {
+      multidx_->erase_seq(position.get_seq());
     }
 
    private:
     friend class MultiIndex;
     Index(MultiIndex *midx) : multidx_(midx) {}
+
+    Tree &tree() { return hana::at_c<Number>(multidx_->trees_); }
+
     MultiIndex *multidx_;
   };
 
@@ -815,8 +1189,9 @@ class MultiIndex {
   template <Name::Raw IndexName>
   auto get_index() {
     static_assert(
-        !check_index_unique<IndexName>(),
-        "name provided cannot be the unique index within multi_index");
+        !check_index_unique<IndexName>() || check_index_covering<IndexName>(),
+        "name provided cannot be the unique index within multi_index, unless "
+        "it covers projections");
     auto res = hana::find_if(indices_, [&](auto &&idx) {
       typedef typename decltype(+hana::at_c<0>(idx))::type IndexType;
       return std::integral_constant<
@@ -849,7 +1224,7 @@ class MultiIndex {
     } else {
       auto item = std::make_shared<Item>(this, [&](auto &i) {
         T &obj = static_cast<T &>(i);
-        get_state_db(static_cast<uint64_t>(TableName), seq, obj);
+        load_row(seq, obj);
         i.$seq = seq;
       });
       seq2item_[seq] = item;
@@ -883,7 +1258,7 @@ class MultiIndex {
       T &obj = static_cast<T &>(*item_);
       auto &seq2item = multiIndex_->seq2item_;
       if (seq2item.find(item_->$seq) == seq2item.end()) {
-        get_state_db(static_cast<uint64_t>(TableName), item_->$seq, obj);
+        multiIndex_->load_row(item_->$seq, obj);
         seq2item[item_->$seq] = item_;
       }
       return obj;
@@ -897,23 +1272,7 @@ class MultiIndex {
         return *this;
       }
 
-      auto &seq2item = multiIndex_->seq2item_;
-      uint64_t seq = item_->$seq + 1;
-      if (seq2item.find(seq) == seq2item.end()) {
-        for (; seq < end_seq; ++seq) {
-          if (has_state_db(static_cast<uint64_t>(TableName), seq)) break;
-        }
-
-        // get item
-        if (seq2item.find(seq) != seq2item.end()) {
-          item_ = seq2item[seq];
-        } else {
-          item_ = std::make_shared<Item>(multiIndex_,
-                                         [&](auto &i) { i.$seq = seq; });
-        }
-      } else {
-        item_ = seq2item[seq];
-      }
+      reset_seq(multiIndex_->next_seq(item_->$seq));
       return *this;
     }
 
@@ -924,29 +1283,7 @@ class MultiIndex {
     }
 
     const_iterator &operator--() {
-      uint64_t end_seq = multiIndex_->seq_.get();
-      uint64_t seq = 0 == item_->$seq ? end_seq : item_->$seq - 1;
-      auto &seq2item = multiIndex_->seq2item_;
-      if (seq2item.find(seq) == seq2item.end()) {
-        constexpr uint64_t begin_seq = 0;
-        for (; seq >= begin_seq; --seq) {
-          if (has_state_db(static_cast<uint64_t>(TableName), seq)) break;
-          if (seq == begin_seq) {
-            seq = end_seq;
-            break;
-          }
-        }
-
-        // get item
-        if (seq2item.find(seq) != seq2item_.end()) {
-          item_ = seq2item[seq];
-        } else {
-          item_ = std::make_shared<Item>(multiIndex_,
-                                         [&](auto &i) { i.$seq = seq; });
-        }
-      } else {
-        item_ = seq2item[seq];
-      }
+      reset_seq(multiIndex_->previous_seq(item_->$seq));
       return *this;
     }
 
@@ -962,6 +1299,17 @@ class MultiIndex {
 
     void reset(std::shared_ptr<Item> i) { item_ = i; }
 
+    void reset_seq(uint64_t seq) {
+      auto &seq2item = multiIndex_->seq2item_;
+      auto iter = seq2item.find(seq);
+      if (iter != seq2item.end()) {
+        item_ = iter->second;
+      } else {
+        item_ = std::make_shared<Item>(multiIndex_,
+                                       [&](auto &i) { i.$seq = seq; });
+      }
+    }
+
     MultiIndex *multiIndex_;
     std::shared_ptr<Item> item_;
     friend class MultiIndex;
@@ -996,20 +1344,8 @@ class MultiIndex {
    * @endcode
    */
   const_iterator cbegin() {
-    uint64_t begin_seq = 0;
-    uint64_t end_seq = seq_.get();
-    for (; begin_seq < end_seq; ++begin_seq) {
-      if (has_state_db(static_cast<uint64_t>(TableName), begin_seq)) break;
-    }
-
     const_iterator result(this, nullptr);
-    if (seq2item_.find(begin_seq) != seq2item_.end()) {
-      result.reset(seq2item_[begin_seq]);
-    } else {
-      auto item =
-          std::make_shared<Item>(this, [&](auto &i) { i.$seq = begin_seq; });
-      result.reset(item);
-    }
+    result.reset_seq(next_seq(kSeqListHead));
     return result;
   }
 
@@ -1088,6 +1424,10 @@ class MultiIndex {
    */
   template <typename Lambda>
   std::pair<const_iterator, bool> emplace(Lambda &&constructor) {
+    // the list of live rows must not see the new sequence id before it is
+    // linked
+    load_links();
+
     // create new item
     auto item = std::make_shared<Item>(this, [&](auto &i) {
       T &obj = static_cast<T &>(i);
@@ -1102,8 +1442,7 @@ class MultiIndex {
       bool is_conflict = hana::any_of(indices_, [&](auto &idx) {
         typedef typename decltype(+hana::at_c<0>(idx))::type IndexType;
         if (IndexType::unique()) {
-          if (check_unique<typename IndexType::SecondaryKeyType>(
-                  IndexType::table_name(), IndexType::index_name(),
+          if (check_unique<TableName, IndexType::kIndexRaw>(
                   IndexType::extract_secondary_key(obj)))
             return true;
         }
@@ -1119,19 +1458,22 @@ class MultiIndex {
     hana::for_each(indices_, [&](auto &idx) {
       typedef typename decltype(+hana::at_c<0>(idx))::type IndexType;
       // todo set index into statedb
-      if (IndexType::unique()) {
-        set_index_db<typename IndexType::SecondaryKeyType>(
-            IndexType::table_name(), IndexType::index_name(), item->$seq,
-            IndexType::extract_secondary_key(obj));
+      if constexpr (IndexType::ordered()) {
+        hana::at_c<IndexType::index_number()>(trees_).insert(
+            IndexType::extract_secondary_key(obj), item->$seq);
+      } else if (IndexType::primary()) {
+        // written with the row
+      } else if (IndexType::unique()) {
+        IndexType::set_unique_db(item->$seq, obj);
       } else {
         // todo append new
-        append_normal_index_one_db<typename IndexType::SecondaryKeyType>(
-            IndexType::table_name(), IndexType::index_name(), item->$seq,
-            IndexType::extract_secondary_key(obj));
+        append_normal_index_one_db<TableName, IndexType::kIndexRaw>(
+            item->$seq, IndexType::extract_secondary_key(obj));
       }
     });
 
-    set_state_db(static_cast<uint64_t>(TableName), item->$seq, obj);
+    store_row(item->$seq, obj, true);
+    link_seq(item->$seq);
 
     // add
     seq2item_[item->$seq] = item;
@@ -1140,7 +1482,8 @@ class MultiIndex {
   }
 
   /**
-   * @brief Find the data, Only a unique index is available.
+   * @brief Find the data, Only a unique index is available. Through a
+   * primary index the row is read together with its key.
    *
    * @param key key of index
    * @return the first iterator. cend() if not found.
@@ -1172,24 +1515,27 @@ class MultiIndex {
   const_iterator find(const KEY &key) {
     static_assert(check_index_unique<IndexName>(),
                   "name provided is not the unique index within multi_index");
-    const_iterator result = cend();
+    std::shared_ptr<Item> item;
     hana::any_of(indices_, [&](auto &idx) {
-      uint64_t index_name = static_cast<uint64_t>(IndexName);
       typedef typename decltype(+hana::at_c<0>(idx))::type IndexType;
-      if (IndexType::index_name() == index_name) {
-        if (has_index_db(static_cast<uint64_t>(TableName),
-                         static_cast<uint64_t>(IndexName), key)) {
-          uint64_t seq = get_index_db<KEY, uint64_t>(
-              static_cast<uint64_t>(TableName),
-              static_cast<uint64_t>(IndexName), key);
-          auto item = get_item_ptr(seq);
-          result.reset(item);
+      if constexpr (IndexType::index_name() == uint64_t(IndexName)) {
+        if constexpr (IndexType::primary()) {
+          // a single read for the sequence id and the row
+          typename IndexType::SecondaryKeyType primary_key(key);
+          PrimaryRow<T> row;
+          if (get_primary_db<TableName, IndexName>(primary_key, row)) {
+            item = cache_row(row);
+          }
+        } else {
+          uint64_t seq = 0;
+          if (IndexType::get_unique_db(key, seq)) item = get_item_ptr(seq);
         }
         return true;
       }
       return false;
     });
-    return result;
+    // the end position costs a read, it is built only when not found
+    return item ? const_iterator(this, item) : cend();
   }
 
   /**
@@ -1227,16 +1573,19 @@ class MultiIndex {
       uint64_t index_name = static_cast<uint64_t>(IndexName);
       typedef typename decltype(+hana::at_c<0>(idx))::type IndexType;
       if (IndexType::index_name() == index_name) {
-        if (IndexType::unique()) {
-          if (has_index_db(static_cast<uint64_t>(TableName),
-                           static_cast<uint64_t>(IndexName), key))
+        if constexpr (IndexType::ordered() &&
+                      IndexType::index_name() == uint64_t(IndexName)) {
+          auto &tree = hana::at_c<IndexType::index_number()>(trees_);
+          auto end = tree.upper_bound(key);
+          for (auto it = tree.lower_bound(key); it != end; tree.next(it)) {
+            result++;
+          }
+        } else if (IndexType::unique()) {
+          if (has_index_db<TableName, IndexName>(key))
             result = 1;
         } else {
-          if (has_normal_index_db(static_cast<uint64_t>(TableName),
-                                  static_cast<uint64_t>(IndexName), key))
-            result = get_normal_index_count_db(static_cast<uint64_t>(TableName),
-                                               static_cast<uint64_t>(IndexName),
-                                               key);
+          if (has_normal_index_db<TableName, IndexName>(key))
+            result = get_normal_index_count_db<TableName, IndexName>(key);
         }
         return true;
       }
@@ -1247,11 +1596,13 @@ class MultiIndex {
   }
 
   /**
-   * @brief Modify data based on iterator, but cannot modify all index-related
-   * fields .
+   * @brief Modify data based on iterator. Only the index entries whose key
+   * changed are rewritten, the row keeps its sequence id.
    *
    * @param position position of iterator
    * @param constructor lambda function that updates the target object
+   * @return true if the row is modified, false if a changed unique index key
+   * is taken by another row, nothing is changed then
    *
    * Example:
    *
@@ -1277,39 +1628,10 @@ class MultiIndex {
    * @endcode
    */
   template <typename Lambda>
-  void modify(const_iterator position, Lambda &&constructor) {
+  bool modify(const_iterator position, Lambda &&constructor) {
     // reduce query statedb operation, don't chekc exists position in statedb
     // so user need make sure position exists
-    // create new item
-    auto item = std::make_shared<Item>(this, [&](auto &i) {
-      T &obj = static_cast<T &>(i);
-      obj = *position;
-      constructor(obj);
-      i.$seq = position.item_->$seq;
-    });
-
-    T &new_obj = static_cast<T &>(*item);
-    const T &old_obj = static_cast<const T &>(*position);
-    bool enable = true;
-
-    // update index key is illegal operation
-    hana::any_of(indices_, [&](auto &idx) {
-      typedef typename decltype(+hana::at_c<0>(idx))::type IndexType;
-      // check index key
-      if (IndexType::extract_secondary_key(old_obj) !=
-          IndexType::extract_secondary_key(new_obj)) {
-        enable = false;
-        return true;
-      }
-      return false;
-    });
-
-    if (enable) {
-      // update
-      set_state_db(static_cast<uint64_t>(TableName), position.item_->$seq,
-                   new_obj);
-      seq2item_[item->$seq] = item;
-    }
+    return modify_seq(position.item_->$seq, constructor);
   }
 
   /**
@@ -1342,24 +1664,7 @@ class MultiIndex {
    * @endcode
    */
   void erase(const_iterator position) {
-    hana::for_each(indices_, [&](auto &idx) {
-      typedef typename decltype(+hana::at_c<0>(idx))::type IndexType;
-      if (IndexType::unique()) {
-        delete_index_db<typename IndexType::SecondaryKeyType>(
-            IndexType::table_name(), IndexType::index_name(),
-            IndexType::extract_secondary_key(*position));
-      } else {
-        delete_normal_index_db<typename IndexType::SecondaryKeyType>(
-            IndexType::table_name(), IndexType::index_name(),
-            position.item_->$seq, IndexType::extract_secondary_key(*position));
-      }
-    });
-
-    // delete key
-    delete_state_db(static_cast<uint64_t>(TableName), position.item_->$seq);
-
-    // delete
-    seq2item_.erase(position.item_->$seq);
+    erase_seq(position.item_->$seq);
   }
 
   static constexpr auto transform_indices() {
@@ -1377,7 +1682,8 @@ class MultiIndex {
           hana::type_c<
               Index<Name::Raw(static_cast<uint64_t>(IdxType::IndexName)),
                     typename IdxType::SecondaryExtractorType, NumType::e::value,
-                    typename IdxType::SecondaryExtractorType::IndexType>>);
+                    typename IdxType::SecondaryExtractorType::IndexType,
+                    typename IdxType::ProjectionType>>);
     });
   }
 
@@ -1385,6 +1691,18 @@ class MultiIndex {
 
   IndicesType indices_;
 
+  static auto transform_trees() {
+    return hana::transform(IndicesType(), [&](auto &&idx) {
+      typedef typename decltype(+hana::at_c<0>(idx))::type IndexType;
+      return typename IndexType::Tree();
+    });
+  }
+
+  typedef decltype(MultiIndex::transform_trees()) TreesType;
+
+  // the B+-trees of the ordered indexes, in the order of the indexes
+  TreesType trees_;
+
   static constexpr bool has_unique_index() {
     return hana::any_of(IndicesType(), [&](auto &idx) {
       typedef typename decltype(+hana::at_c<0>(idx))::type IndexType;
@@ -1392,6 +1710,69 @@ class MultiIndex {
     });
   }
 
+  static constexpr bool has_primary_index() {
+    return hana::any_of(IndicesType(), [&](auto &idx) {
+      typedef typename decltype(+hana::at_c<0>(idx))::type IndexType;
+      return IndexType::primary();
+    });
+  }
+
+  static constexpr size_t primary_index_count() {
+    return hana::count_if(IndicesType(), [&](auto &&idx) {
+      typedef typename decltype(+hana::at_c<0>(idx))::type IndexType;
+      return IndexType::primary();
+    });
+  }
+
+  // With a primary index the row is stored under the primary key together
+  // with its sequence id, and the sequence id keeps the primary key.
+  // moved: whether the primary key is new for the sequence id
+  void store_row(uint64_t seq, const T &obj, bool moved) {
+    static_assert(primary_index_count() <= 1,
+                  "multi_index supports at most one primary index");
+    if constexpr (has_primary_index()) {
+      hana::for_each(indices_, [&](auto &idx) {
+        typedef typename decltype(+hana::at_c<0>(idx))::type IndexType;
+        if constexpr (IndexType::primary()) {
+          auto key = IndexType::extract_secondary_key(obj);
+          set_primary_db<TableName, IndexType::kIndexRaw>(key, seq, obj);
+          if (moved) set_state_db<TableName>(seq, key);
+        }
+      });
+    } else {
+      set_state_db<TableName>(seq, obj);
+    }
+  }
+
+  void load_row(uint64_t seq, T &obj) {
+    if constexpr (has_primary_index()) {
+      hana::for_each(indices_, [&](auto &idx) {
+        typedef typename decltype(+hana::at_c<0>(idx))::type IndexType;
+        if constexpr (IndexType::primary()) {
+          typename IndexType::SecondaryKeyType key;
+          get_state_db<TableName>(seq, key);
+          PrimaryRow<T> row;
+          get_primary_db<TableName, IndexType::kIndexRaw>(key, row);
+          obj = std::move(row.row);
+        }
+      });
+    } else {
+      get_state_db<TableName>(seq, obj);
+    }
+  }
+
+  // the cached item of a row read through the primary index
+  std::shared_ptr<Item> cache_row(PrimaryRow<T> &row) {
+    auto iter = seq2item_.find(row.seq);
+    if (iter != seq2item_.end()) return iter->second;
+    auto item = std::make_shared<Item>(this, [&](auto &i) {
+      static_cast<T &>(i) = std::move(row.row);
+      i.$seq = row.seq;
+    });
+    seq2item_[row.seq] = item;
+    return item;
+  }
+
   template <Name::Raw IndexName>
   static constexpr bool check_index_unique() {
     return hana::any_of(IndicesType(), [&](auto &idx) {
@@ -1401,6 +1782,15 @@ class MultiIndex {
     });
   }
 
+  template <Name::Raw IndexName>
+  static constexpr bool check_index_covering() {
+    return hana::any_of(IndicesType(), [&](auto &idx) {
+      typedef typename decltype(+hana::at_c<0>(idx))::type IndexType;
+      return IndexType::index_name() == static_cast<uint64_t>(IndexName) &&
+             IndexType::covering();
+    });
+  }
+
   template <Name::Raw IndexName>
   static constexpr bool check_index_exist() {
     return hana::any_of(IndicesType(), [&](auto &idx) {
@@ -1409,6 +1799,270 @@ class MultiIndex {
     });
   }
 
+  template <typename Lambda>
+  bool modify_seq(uint64_t seq, Lambda &&constructor) {
+    // the cached row is updated in place, so that every iterator sees it
+    auto item = get_item_ptr(seq);
+    const T &old_obj = static_cast<const T &>(*item);
+    T new_obj = old_obj;
+    constructor(new_obj);
+
+    // a changed unique index key must be free
+    bool is_conflict = hana::any_of(indices_, [&](auto &idx) {
+      typedef typename decltype(+hana::at_c<0>(idx))::type IndexType;
+      if constexpr (IndexType::unique()) {
+        auto key = IndexType::extract_secondary_key(new_obj);
+        return key != IndexType::extract_secondary_key(old_obj) &&
+               check_unique<TableName, IndexType::kIndexRaw>(key);
+      }
+      return false;
+    });
+    if (is_conflict) return false;
+
+    // move the index entries whose key changed
+    bool moved = false;
+    hana::for_each(indices_, [&](auto &idx) {
+      typedef typename decltype(+hana::at_c<0>(idx))::type IndexType;
+      auto old_key = IndexType::extract_secondary_key(old_obj);
+      auto new_key = IndexType::extract_secondary_key(new_obj);
+      if constexpr (IndexType::covering()) {
+        // the covered values are rewritten too
+        if (old_key != new_key) {
+          delete_index_db<TableName, IndexType::kIndexRaw>(old_key);
+        } else if (IndexType::extract_projection(old_obj) ==
+                   IndexType::extract_projection(new_obj)) {
+          return;
+        }
+        IndexType::set_unique_db(seq, new_obj);
+        return;
+      }
+      if (old_key == new_key) return;
+      if constexpr (IndexType::ordered()) {
+        auto &tree = hana::at_c<IndexType::index_number()>(trees_);
+        tree.erase(old_key, seq);
+        tree.insert(new_key, seq);
+      } else if (IndexType::primary()) {
+        // the row moves to the new key
+        delete_index_db<TableName, IndexType::kIndexRaw>(old_key);
+        moved = true;
+      } else if (IndexType::unique()) {
+        delete_index_db<TableName, IndexType::kIndexRaw>(old_key);
+        IndexType::set_unique_db(seq, new_obj);
+      } else {
+        delete_normal_index_db<TableName, IndexType::kIndexRaw>(seq, old_key);
+        insert_normal_index_db<TableName, IndexType::kIndexRaw>(seq, new_key);
+      }
+    });
+
+    // update
+    store_row(seq, new_obj, moved);
+    static_cast<T &>(*item) = std::move(new_obj);
+    return true;
+  }
+
+  void erase_seq(uint64_t seq) {
+    auto item = get_item_ptr(seq);
+    const T &obj = static_cast<const T &>(*item);
+    hana::for_each(indices_, [&](auto &idx) {
+      typedef typename decltype(+hana::at_c<0>(idx))::type IndexType;
+      if constexpr (IndexType::ordered()) {
+        hana::at_c<IndexType::index_number()>(trees_).erase(
+            IndexType::extract_secondary_key(obj), seq);
+      } else if (IndexType::unique()) {
+        delete_index_db<TableName, IndexType::kIndexRaw>(
+            IndexType::extract_secondary_key(obj));
+      } else {
+        delete_normal_index_db<TableName, IndexType::kIndexRaw>(
+            seq, IndexType::extract_secondary_key(obj));
+      }
+    });
+
+    // delete key
+    delete_state_db<TableName>(seq);
+    unlink_seq(seq);
+
+    // delete
+    seq2item_.erase(seq);
+  }
+
+  // The live sequence ids form a doubly linked list in the state, so that
+  // iterating costs one read per live row whatever the number of erased ones.
+  // Tables written before the list existed are linked kSeqLinkBatch sequence
+  // ids per object, the ones not linked yet are probed meanwhile. A CONST
+  // action links nothing, it probes the rows past the stored cursor.
+  enum LinkState : uint8_t { kLinkAbsent, kLinkLive, kLinkErased };
+
+  // an erased link keeps its neighbours, so that ++ and -- from an iterator
+  // of an erased row still reach the live rows next to it
+  std::map<uint64_t, std::pair<LinkState, SeqLink>> links_;
+  bool links_loaded_ = false;
+  bool linking_ = false;
+  uint64_t link_cursor_ = 0;
+
+  void load_links() {
+    if (links_loaded_) return;
+    links_loaded_ = true;
+    if (find_link(kSeqListHead) != nullptr) {
+      linking_ = get_state(SeqLinkCursorKey<TableName>(), link_cursor_) != 0;
+    } else if (0 == seq_.get()) {
+      links_[kSeqListHead] =
+          std::make_pair(kLinkLive, SeqLink{kSeqListHead, kSeqListHead});
+      return;
+    } else {
+      SeqLink head{kSeqListHead, kSeqListHead};
+      if (StateCache::instance().read_only()) {
+        links_[kSeqListHead] = std::make_pair(kLinkLive, head);
+      } else {
+        set_link(kSeqListHead, head);
+      }
+      linking_ = true;
+      link_cursor_ = 0;
+    }
+    if (linking_ && !StateCache::instance().read_only()) link_batch();
+  }
+
+  // link the next sequence ids of a table written before the list existed
+  void link_batch() {
+    uint64_t end_seq = seq_.get();
+    uint64_t last = std::min(end_seq, link_cursor_ + kSeqLinkBatch);
+    for (; link_cursor_ < last; ++link_cursor_) {
+      if (has_state_db<TableName>(link_cursor_)) append_link(link_cursor_);
+    }
+    if (link_cursor_ == end_seq) {
+      linking_ = false;
+      del_state(SeqLinkCursorKey<TableName>());
+    } else {
+      set_state(SeqLinkCursorKey<TableName>(), link_cursor_);
+    }
+  }
+
+  const SeqLink *find_link(uint64_t seq) {
+    auto iter = links_.find(seq);
+    if (iter == links_.end()) {
+      SeqLink link;
+      LinkState state = get_state(SeqLinkKey<TableName>(seq), link) != 0
+                            ? kLinkLive
+                            : kLinkAbsent;
+      iter = links_.emplace(seq, std::make_pair(state, link)).first;
+    }
+    return kLinkLive == iter->second.first ? &iter->second.second : nullptr;
+  }
+
+  void set_link(uint64_t seq, const SeqLink &link) {
+    links_[seq] = std::make_pair(kLinkLive, link);
+    set_state(SeqLinkKey<TableName>(seq), link);
+  }
+
+  // append the largest linked sequence id
+  void append_link(uint64_t seq) {
+    SeqLink head = *find_link(kSeqListHead);
+    set_link(seq, SeqLink{head.previous, kSeqListHead});
+    if (kSeqListHead == head.previous) {
+      head.next = seq;
+    } else {
+      SeqLink last = *find_link(head.previous);
+      last.next = seq;
+      set_link(head.previous, last);
+    }
+    head.previous = seq;
+    set_link(kSeqListHead, head);
+  }
+
+  // a new sequence id, it is the largest one
+  void link_seq(uint64_t seq) {
+    load_links();
+    // still probed while the table is being linked
+    if (linking_) return;
+    append_link(seq);
+  }
+
+  void unlink_seq(uint64_t seq) {
+    load_links();
+    if (linking_ && seq >= link_cursor_) return;
+    const SeqLink *found = find_link(seq);
+    if (nullptr == found) return;
+    SeqLink link = *found;
+    SeqLink previous = *find_link(link.previous);
+    previous.next = link.next;
+    set_link(link.previous, previous);
+    SeqLink next = *find_link(link.next);
+    next.previous = link.previous;
+    set_link(link.next, next);
+    links_[seq].first = kLinkErased;
+    del_state(SeqLinkKey<TableName>(seq));
+  }
+
+  // the link of a live or erased sequence id, nullptr if there is none
+  const SeqLink *any_link(uint64_t seq) {
+    if (find_link(seq) != nullptr) return find_link(seq);
+    auto iter = links_.find(seq);
+    return kLinkErased == iter->second.first ? &iter->second.second : nullptr;
+  }
+
+  // first stored sequence id in [first, end_seq), end_seq if there is none
+  uint64_t probe_next(uint64_t first, uint64_t end_seq) {
+    for (uint64_t seq = first; seq < end_seq; ++seq) {
+      if (has_state_db<TableName>(seq)) return seq;
+    }
+    return end_seq;
+  }
+
+  // last stored sequence id in [link_cursor_, last], end_seq if there is none
+  uint64_t probe_previous(uint64_t last, uint64_t end_seq) {
+    for (uint64_t seq = last + 1; seq > link_cursor_; --seq) {
+      if (has_state_db<TableName>(seq - 1)) return seq - 1;
+    }
+    return end_seq;
+  }
+
+  // live sequence id after seq, the end sequence id after the last one
+  uint64_t next_seq(uint64_t seq) {
+    load_links();
+    uint64_t end_seq = seq_.get();
+    if (seq == end_seq) seq = kSeqListHead;
+    if (linking_ && kSeqListHead != seq && seq >= link_cursor_) {
+      return probe_next(seq + 1, end_seq);
+    }
+    const SeqLink *link = any_link(seq);
+    if (nullptr == link) return end_seq;
+    uint64_t next = link->next;
+    while (kSeqListHead != next && find_link(next) == nullptr) {
+      link = any_link(next);
+      if (nullptr == link) return end_seq;
+      next = link->next;
+    }
+    if (kSeqListHead == next) {
+      return linking_ ? probe_next(link_cursor_, end_seq) : end_seq;
+    }
+    return next;
+  }
+
+  // live sequence id before seq, the end sequence id before the first one
+  uint64_t previous_seq(uint64_t seq) {
+    load_links();
+    uint64_t end_seq = seq_.get();
+    if (linking_ && kSeqListHead != seq &&
+        (seq == end_seq || seq >= link_cursor_)) {
+      uint64_t last = seq == end_seq ? end_seq : seq;
+      if (last > link_cursor_) {
+        uint64_t previous = probe_previous(last - 1, end_seq);
+        if (previous != end_seq) return previous;
+      }
+      seq = kSeqListHead;
+    } else if (seq == end_seq) {
+      seq = kSeqListHead;
+    }
+    const SeqLink *link = any_link(seq);
+    if (nullptr == link) return end_seq;
+    uint64_t previous = link->previous;
+    while (kSeqListHead != previous && find_link(previous) == nullptr) {
+      link = any_link(previous);
+      if (nullptr == link) return end_seq;
+      previous = link->previous;
+    }
+    return kSeqListHead == previous ? end_seq : previous;
+  }
+
   Uint64<TableName> seq_;
 };
 }  // namespace db
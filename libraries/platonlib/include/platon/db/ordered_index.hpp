@@ -0,0 +1,396 @@
+#pragma once
+
+#include <map>
+#include <vector>
+#include "platon/db/state_key.hpp"
+#include "platon/name.hpp"
+#include "platon/rlp_serialize.hpp"
+#include "platon/storage.hpp"
+
+namespace platon {
+namespace db {
+
+// ordered index node id -> node, the id 0 holds the tree root
+template <Name::Raw TableName, Name::Raw IndexName>
+using OrderedNodeKey =
+    PrefixedKey<KeyPrefix<TableName, IndexName, "$tree"_n>, uint64_t>;
+
+/**
+ * @brief Node of an ordered index B+-tree
+ *
+ * A leaf holds sorted (key, sequence id) entries and is linked to its
+ * siblings. An internal node holds the separating entries, child i holds the
+ * entries from separator i - 1 up to, but excluding, separator i.
+ */
+template <typename K>
+struct OrderedNode {
+  std::vector<K> keys;
+  std::vector<uint64_t> seqs;
+  // child node ids, empty for a leaf
+  std::vector<uint64_t> children;
+  // sibling leaves, 0 for none
+  uint64_t previous = 0;
+  uint64_t next = 0;
+
+  bool leaf() const { return children.empty(); }
+
+  PLATON_SERIALIZE(OrderedNode, (keys)(seqs)(children)(previous)(next))
+};
+
+struct OrderedRoot {
+  // root node id, 0 for an empty tree
+  uint64_t root = 0;
+  uint64_t next_id = 1;
+
+  PLATON_SERIALIZE(OrderedRoot, (root)(next_id))
+};
+
+/**
+ * @brief B+-tree of (key, sequence id) entries stored in the state
+ *
+ * Every node is stored under a key of its own and read when it is first
+ * used, the nodes read or written are cached for the life of the tree.
+ * Entries with equal keys are ordered by sequence id. Emptied nodes are
+ * freed, nodes that are only underfull are not merged.
+ *
+ * @tparam TableName Table name
+ * @tparam IndexName Index name
+ * @tparam K Key type
+ * @tparam NodeSize Maximum number of entries of a leaf and of children of an
+ * internal node, larger nodes make the tree shallower and each node read
+ * more expensive
+ */
+template <Name::Raw TableName, Name::Raw IndexName, typename K,
+          size_t NodeSize>
+class OrderedTree {
+ public:
+  static_assert(NodeSize >= 4, "ordered index nodes need at least 4 entries");
+
+  /// Position of an entry, the node id 0 is the end position.
+  struct Cursor {
+    uint64_t node = 0;
+    size_t pos = 0;
+
+    bool operator==(const Cursor &other) const {
+      return node == other.node && pos == other.pos;
+    }
+    bool operator!=(const Cursor &other) const { return !(*this == other); }
+  };
+
+  /// First entry whose key is not less than @a key.
+  Cursor lower_bound(const K &key) { return search(key, 0, false); }
+
+  /// First entry whose key is greater than @a key.
+  Cursor upper_bound(const K &key) { return search(key, UINT64_MAX, true); }
+
+  /// The entry (@a key, @a seq), or the first one after it if it is erased.
+  Cursor seek(const K &key, uint64_t seq) { return search(key, seq, false); }
+
+  /// Changed by every insert and erase, cursors taken before are stale.
+  uint64_t version() const { return version_; }
+
+  Cursor first() {
+    uint64_t id = root().root;
+    if (0 == id) return Cursor();
+    while (!node(id).leaf()) id = node(id).children.front();
+    return Cursor{id, 0};
+  }
+
+  Cursor last() {
+    uint64_t id = root().root;
+    if (0 == id) return Cursor();
+    while (!node(id).leaf()) id = node(id).children.back();
+    const Node &leaf = node(id);
+    if (leaf.keys.empty()) return Cursor();
+    return Cursor{id, leaf.keys.size() - 1};
+  }
+
+  void next(Cursor &cursor) {
+    if (0 == cursor.node) return;
+    const Node &leaf = node(cursor.node);
+    if (++cursor.pos < leaf.keys.size()) return;
+    cursor = Cursor{leaf.next, 0};
+  }
+
+  /// The entry before @a cursor, the last entry before the end.
+  void previous(Cursor &cursor) {
+    if (0 == cursor.node) {
+      cursor = last();
+      return;
+    }
+    if (cursor.pos > 0) {
+      --cursor.pos;
+      return;
+    }
+    uint64_t id = node(cursor.node).previous;
+    cursor = 0 == id ? Cursor() : Cursor{id, node(id).keys.size() - 1};
+  }
+
+  const K &key(const Cursor &cursor) {
+    return node(cursor.node).keys[cursor.pos];
+  }
+
+  uint64_t seq(const Cursor &cursor) {
+    return node(cursor.node).seqs[cursor.pos];
+  }
+
+  /**
+   * @brief Add an entry
+   *
+   * @param key Key
+   * @param seq Sequence id of the row
+   */
+  void insert(const K &key, uint64_t seq) {
+    version_++;
+    OrderedRoot &tree = root();
+    if (0 == tree.root) {
+      Node leaf;
+      leaf.keys.push_back(key);
+      leaf.seqs.push_back(seq);
+      tree.root = tree.next_id++;
+      store(tree.root, leaf);
+      store_root();
+      return;
+    }
+
+    std::vector<std::pair<uint64_t, size_t>> path;
+    uint64_t id = descend(key, seq, path);
+    Node leaf = node(id);
+    size_t pos = upper(leaf, key, seq);
+    leaf.keys.insert(leaf.keys.begin() + pos, key);
+    leaf.seqs.insert(leaf.seqs.begin() + pos, seq);
+    if (leaf.keys.size() <= NodeSize) {
+      store(id, leaf);
+      return;
+    }
+
+    // split the leaf, the right half goes to a new node
+    size_t half = leaf.keys.size() / 2;
+    Node right;
+    right.keys.assign(leaf.keys.begin() + half, leaf.keys.end());
+    right.seqs.assign(leaf.seqs.begin() + half, leaf.seqs.end());
+    leaf.keys.resize(half);
+    leaf.seqs.resize(half);
+    uint64_t right_id = tree.next_id++;
+    right.previous = id;
+    right.next = leaf.next;
+    if (0 != leaf.next) {
+      Node after = node(leaf.next);
+      after.previous = right_id;
+      store(leaf.next, after);
+    }
+    leaf.next = right_id;
+    store(id, leaf);
+    store(right_id, right);
+    promote(path, id, right.keys.front(), right.seqs.front(), right_id);
+    store_root();
+  }
+
+  /**
+   * @brief Remove an entry
+   *
+   * @param key Key
+   * @param seq Sequence id of the row
+   */
+  void erase(const K &key, uint64_t seq) {
+    if (0 == root().root) return;
+    std::vector<std::pair<uint64_t, size_t>> path;
+    uint64_t id = descend(key, seq, path);
+    Node leaf = node(id);
+    size_t pos = lower(leaf, key, seq);
+    if (pos == leaf.keys.size() ||
+        less(key, seq, leaf.keys[pos], leaf.seqs[pos]))
+      return;
+    version_++;
+    leaf.keys.erase(leaf.keys.begin() + pos);
+    leaf.seqs.erase(leaf.seqs.begin() + pos);
+    if (!leaf.keys.empty()) {
+      store(id, leaf);
+      return;
+    }
+
+    // unlink the empty leaf from its siblings and free it
+    if (0 != leaf.previous) {
+      Node before = node(leaf.previous);
+      before.next = leaf.next;
+      store(leaf.previous, before);
+    }
+    if (0 != leaf.next) {
+      Node after = node(leaf.next);
+      after.previous = leaf.previous;
+      store(leaf.next, after);
+    }
+    remove(id);
+
+    // remove the freed nodes from their parents
+    while (!path.empty()) {
+      uint64_t parent_id = path.back().first;
+      size_t child = path.back().second;
+      path.pop_back();
+      Node parent = node(parent_id);
+      parent.children.erase(parent.children.begin() + child);
+      if (!parent.keys.empty()) {
+        size_t separator = child > 0 ? child - 1 : 0;
+        parent.keys.erase(parent.keys.begin() + separator);
+        parent.seqs.erase(parent.seqs.begin() + separator);
+      }
+      if (!parent.children.empty()) {
+        if (path.empty() && 1 == parent.children.size()) {
+          // the only child becomes the root
+          root().root = parent.children.front();
+          remove(parent_id);
+          store_root();
+        } else {
+          store(parent_id, parent);
+        }
+        return;
+      }
+      remove(parent_id);
+    }
+    root().root = 0;
+    store_root();
+  }
+
+ private:
+  typedef OrderedNode<K> Node;
+
+  static bool less(const K &a, uint64_t a_seq, const K &b, uint64_t b_seq) {
+    if (a < b) return true;
+    if (b < a) return false;
+    return a_seq < b_seq;
+  }
+
+  // first entry of the node not less than (key, seq)
+  static size_t lower(const Node &n, const K &key, uint64_t seq) {
+    size_t low = 0, high = n.keys.size();
+    while (low < high) {
+      size_t mid = (low + high) / 2;
+      if (less(n.keys[mid], n.seqs[mid], key, seq)) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    return low;
+  }
+
+  // first entry of the node greater than (key, seq)
+  static size_t upper(const Node &n, const K &key, uint64_t seq) {
+    size_t low = 0, high = n.keys.size();
+    while (low < high) {
+      size_t mid = (low + high) / 2;
+      if (less(key, seq, n.keys[mid], n.seqs[mid])) {
+        high = mid;
+      } else {
+        low = mid + 1;
+      }
+    }
+    return low;
+  }
+
+  // leaf that holds (key, seq), the path records each parent and child index
+  uint64_t descend(const K &key, uint64_t seq,
+                   std::vector<std::pair<uint64_t, size_t>> &path) {
+    uint64_t id = root().root;
+    while (!node(id).leaf()) {
+      size_t child = upper(node(id), key, seq);
+      path.emplace_back(id, child);
+      id = node(id).children[child];
+    }
+    return id;
+  }
+
+  Cursor search(const K &key, uint64_t seq, bool after) {
+    if (0 == root().root) return Cursor();
+    std::vector<std::pair<uint64_t, size_t>> path;
+    uint64_t id = descend(key, seq, path);
+    const Node &leaf = node(id);
+    size_t pos = after ? upper(leaf, key, seq) : lower(leaf, key, seq);
+    if (pos < leaf.keys.size()) return Cursor{id, pos};
+    return Cursor{leaf.next, 0};
+  }
+
+  // insert the separator of a split child into the parents
+  void promote(std::vector<std::pair<uint64_t, size_t>> &path,
+               uint64_t left_id, K key, uint64_t seq, uint64_t right_id) {
+    OrderedRoot &tree = root();
+    while (!path.empty()) {
+      uint64_t parent_id = path.back().first;
+      size_t child = path.back().second;
+      path.pop_back();
+      Node parent = node(parent_id);
+      parent.keys.insert(parent.keys.begin() + child, key);
+      parent.seqs.insert(parent.seqs.begin() + child, seq);
+      parent.children.insert(parent.children.begin() + child + 1, right_id);
+      if (parent.children.size() <= NodeSize) {
+        store(parent_id, parent);
+        return;
+      }
+
+      // split the internal node, the middle separator moves up
+      size_t mid = parent.keys.size() / 2;
+      Node right;
+      right.keys.assign(parent.keys.begin() + mid + 1, parent.keys.end());
+      right.seqs.assign(parent.seqs.begin() + mid + 1, parent.seqs.end());
+      right.children.assign(parent.children.begin() + mid + 1,
+                            parent.children.end());
+      key = parent.keys[mid];
+      seq = parent.seqs[mid];
+      parent.keys.resize(mid);
+      parent.seqs.resize(mid);
+      parent.children.resize(mid + 1);
+      right_id = tree.next_id++;
+      left_id = parent_id;
+      store(parent_id, parent);
+      store(right_id, right);
+    }
+
+    // the root was split
+    Node new_root;
+    new_root.keys.push_back(key);
+    new_root.seqs.push_back(seq);
+    new_root.children = {left_id, right_id};
+    tree.root = tree.next_id++;
+    store(tree.root, new_root);
+  }
+
+  OrderedRoot &root() {
+    if (!root_loaded_) {
+      get_state(OrderedNodeKey<TableName, IndexName>(0), root_);
+      root_loaded_ = true;
+    }
+    return root_;
+  }
+
+  void store_root() {
+    set_state(OrderedNodeKey<TableName, IndexName>(0), root_);
+  }
+
+  const Node &node(uint64_t id) {
+    auto iter = nodes_.find(id);
+    if (iter == nodes_.end()) {
+      Node one;
+      get_state(OrderedNodeKey<TableName, IndexName>(id), one);
+      iter = nodes_.emplace(id, std::move(one)).first;
+    }
+    return iter->second;
+  }
+
+  void store(uint64_t id, const Node &one) {
+    nodes_[id] = one;
+    set_state(OrderedNodeKey<TableName, IndexName>(id), one);
+  }
+
+  void remove(uint64_t id) {
+    nodes_.erase(id);
+    del_state(OrderedNodeKey<TableName, IndexName>(id));
+  }
+
+  std::map<uint64_t, Node> nodes_;
+  OrderedRoot root_;
+  bool root_loaded_ = false;
+  uint64_t version_ = 0;
+};
+
+}  // namespace db
+}  // namespace platon
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <map>
+#include "platon/db/state_key.hpp"
+#include "platon/name.hpp"
+#include "platon/storage.hpp"
+
+namespace platon {
+namespace db {
+/**
+ * @brief Set whose members are stored under their own keys
+ *
+ * Membership is the existence of the key of the member, contains() costs a
+ * single state access whatever the number of members. insert() and erase()
+ * cost a single write when the object is destroyed, and only if they change
+ * the stored membership; a member not checked before is read first. The
+ * members are not enumerable.
+ *
+ * @tparam TableName Set name, in the same contract, the name should be unique
+ * @tparam K Member type
+ */
+template <Name::Raw TableName, typename K>
+class Set {
+ public:
+  Set() {}
+
+  Set(const Set<TableName, K> &) = delete;
+  Set(const Set<TableName, K> &&) = delete;
+  Set<TableName, K> &operator=(const Set<TableName, K> &) = delete;
+
+  /**
+   * @brief Destroy the Set object. Refresh the changed members to blockchain
+   *
+   */
+  ~Set() { flush(); }
+
+  /**
+   * @brief Whether @a k is a member
+   *
+   * @param k Member
+   * @return true if it is a member, otherwise false
+   * Example:
+   *
+   * @code
+   * typedef platon::db::Set<"set_str"_n, std::string> SetStr;
+   * SetStr set;
+   * set.insert("hello");
+   * assert(set.contains("hello"));
+   * @endcode
+   */
+  bool contains(const K &k) const {
+    auto iter = cache_.find(k);
+    if (iter != cache_.end()) {
+      return iter->second.member == Present;
+    }
+    Member member = platon::has_state(KeyWrapper(k)) ? Present : Absent;
+    cache_.emplace(k, Entry{member, member});
+    return member == Present;
+  }
+
+  /**
+   * @brief Add @a k to the set, the state is read at flush if needed
+   *
+   * @param k Member
+   */
+  void insert(const K &k) { cache_[k].member = Present; }
+
+  /**
+   * @brief Remove @a k from the set, the state is read at flush if needed
+   *
+   * @param k Member
+   */
+  void erase(const K &k) { cache_[k].member = Absent; }
+
+  /**
+   * @brief Refresh the changed members to blockchain
+   *
+   */
+  void flush() {
+    for (auto &item : cache_) {
+      Entry &entry = item.second;
+      if (entry.member == entry.stored) continue;
+
+      // a read is cheaper than a write that changes nothing
+      if (entry.stored == Unknown) {
+        entry.stored =
+            platon::has_state(KeyWrapper(item.first)) ? Present : Absent;
+        if (entry.member == entry.stored) continue;
+      }
+      if (entry.member == Present) {
+        platon::set_state(KeyWrapper(item.first), true);
+      } else {
+        platon::del_state(KeyWrapper(item.first));
+      }
+      entry.stored = entry.member;
+    }
+  }
+
+ public:
+  static const std::string kType;
+
+ private:
+  static constexpr Name::Raw kTag = "__set__"_n;
+  typedef PrefixedKey<KeyPrefix<TableName, kTag>, K> KeyWrapper;
+
+  enum Member : uint8_t { Unknown, Absent, Present };
+
+  struct Entry {
+    Member stored = Unknown;
+    Member member = Unknown;
+  };
+
+  mutable std::map<K, Entry> cache_;
+};
+
+template <Name::Raw TableName, typename K>
+const std::string Set<TableName, K>::kType = "__set__";
+}  // namespace db
+}  // namespace platon
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <string.h>
+
+#include <array>
+#include <tuple>
+
+#include "platon/RLP.h"
+#include "platon/name.hpp"
+#include "platon/rlp_size.hpp"
+
+namespace platon {
+namespace db {
+
+namespace key_detail {
+constexpr size_t encoded_size(uint64_t value) {
+  if (value < 0x80) return 1;
+  size_t count = 0;
+  for (; value != 0; value >>= 8) ++count;
+  return 1 + count;
+}
+
+template <size_t N>
+constexpr void encode(std::array<byte, N> &out, size_t &pos, uint64_t value) {
+  if (value == 0) {
+    out[pos++] = 0x80;
+  } else if (value < 0x80) {
+    out[pos++] = byte(value);
+  } else {
+    size_t len = encoded_size(value) - 1;
+    out[pos++] = byte(0x80 + len);
+    for (size_t i = len; i > 0; --i) {
+      out[pos++] = byte(value >> ((i - 1) * 8));
+    }
+  }
+}
+}  // namespace key_detail
+
+/**
+ * @brief RLP encoding of the constant names that lead a state key
+ *
+ * The names are encoded as uint64_t list items at compile time, keys built
+ * on the prefix only encode their dynamic part at runtime.
+ *
+ * @tparam Names Names of the container, the index...
+ */
+template <Name::Raw... Names>
+struct KeyPrefix {
+  static constexpr size_t count = sizeof...(Names);
+  static constexpr size_t size =
+      (size_t(0) + ... + key_detail::encoded_size(uint64_t(Names)));
+
+  static constexpr std::array<byte, size> encode() {
+    std::array<byte, size> out{};
+    size_t pos = 0;
+    (key_detail::encode(out, pos, uint64_t(Names)), ...);
+    return out;
+  }
+
+  static constexpr std::array<byte, size> bytes = encode();
+};
+
+/**
+ * @brief State key encoded as the RLP list of a constant prefix followed by
+ * the dynamic parts
+ *
+ * The encoding is the same as a PLATON_SERIALIZE struct with uint64_t name
+ * members followed by the parts. The parts are referenced, the key must not
+ * outlive them.
+ *
+ * @tparam Prefix KeyPrefix of the names
+ * @tparam Ts Types of the dynamic parts
+ */
+template <class Prefix, class... Ts>
+class PrefixedKey {
+ public:
+  explicit PrefixedKey(const Ts &... parts) : parts_(parts...) {}
+
+  friend constexpr size_t platon_max_pack_size(const PrefixedKey *) {
+    if constexpr (((max_pack_size<Ts>() == 0) || ...)) {
+      return 0;
+    } else {
+      constexpr size_t payload =
+          (Prefix::size + ... + max_pack_size<Ts>());
+      return payload + rlp_detail::header_size(payload);
+    }
+  }
+
+  friend RLPStream &operator<<(RLPStream &rlp, const PrefixedKey &key) {
+    if (max_pack_size<PrefixedKey>() == 0 && !rlp.hasListPlan()) {
+      return rlp.appendPlanned(key);
+    }
+    rlp.appendList(Prefix::count + sizeof...(Ts));
+    rlp.appendRaw(bytesConstRef(Prefix::bytes.data(), Prefix::size),
+                  Prefix::count);
+    std::apply([&rlp](const Ts &... parts) { (rlp << ... << parts); },
+               key.parts_);
+    return rlp;
+  }
+
+  friend RLPSize &operator<<(RLPSize &rlps, const PrefixedKey &key) {
+    rlps << RLPSize::list_start();
+    rlps.append_raw(Prefix::size);
+    std::apply([&rlps](const Ts &... parts) { (rlps << ... << parts); },
+               key.parts_);
+    return rlps << RLPSize::list_end();
+  }
+
+ private:
+  std::tuple<const Ts &...> parts_;
+};
+
+/**
+ * @brief State key that is already RLP encoded
+ *
+ * @tparam N Length of the encoding
+ */
+template <size_t N>
+struct EncodedKey {
+  std::array<byte, N> data;
+
+  friend constexpr size_t platon_max_pack_size(const EncodedKey *) {
+    return N;
+  }
+
+  friend RLPStream &operator<<(RLPStream &rlp, const EncodedKey &key) {
+    return rlp.appendRaw(bytesConstRef(key.data.data(), N));
+  }
+
+  friend RLPSize &operator<<(RLPSize &rlps, const EncodedKey &key) {
+    return rlps.append_raw(N);
+  }
+};
+
+}  // namespace db
+}  // namespace platon
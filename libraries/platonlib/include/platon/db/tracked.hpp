@@ -0,0 +1,126 @@
+#pragma once
+
+#include "platon/RLP.h"
+#include "platon/storage.hpp"
+
+namespace platon {
+namespace db {
+
+/**
+ * @brief Cached copy of a state value that knows whether it must be written
+ * back
+ *
+ * Reading the value through get() never causes a write. Handing out a
+ * mutable reference with expose() records the encoding of the value, it is
+ * written back only when the encoding changed. A value that is not stored is
+ * created by expose(), as operator[] of a container always did. modify() and
+ * erase() always write back.
+ *
+ * @tparam T Value type
+ */
+template <typename T>
+class Tracked {
+ public:
+  enum Access : uint8_t { Clean, Exposed, Modified, Erased };
+
+  Tracked() {}
+
+  /**
+   * @brief Construct a value read from the state
+   *
+   * @param value The value
+   * @param stored Whether the state had the value
+   */
+  Tracked(T value, bool stored) : value_(std::move(value)), stored_(stored) {}
+
+  /// Read only access, never written back.
+  const T &get() const { return value_; }
+
+  /**
+   * @brief Mutable access that is written back only if the value changed
+   *
+   * @return T& The value
+   */
+  T &expose() {
+    if (access_ == Erased || (access_ == Clean && !stored_)) return modify();
+    if (access_ == Clean) {
+      ScopedStream stream;
+      stream->appendPlanned(value_);
+      exposed_ = stream->out().toBytes();
+      access_ = Exposed;
+    }
+    return value_;
+  }
+
+  /**
+   * @brief Mutable access that is always written back
+   *
+   * @return T& The value
+   */
+  T &modify() {
+    if (access_ == Erased) value_ = T();
+    access_ = Modified;
+    exposed_.clear();
+    return value_;
+  }
+
+  /// The value is deleted from the state.
+  void erase() {
+    value_ = T();
+    access_ = Erased;
+    exposed_.clear();
+  }
+
+  /// The state was written with the current value.
+  void stored() {
+    access_ = Clean;
+    stored_ = true;
+    exposed_.clear();
+  }
+
+  Access access() const { return access_; }
+
+  /// Whether the value exists once it is written back.
+  bool exists() const {
+    if (access_ == Erased) return false;
+    return stored_ || access_ == Modified || changed();
+  }
+
+  /// Whether the value differs from the one in the state.
+  bool changed() const {
+    if (access_ != Exposed) return access_ == Modified || access_ == Erased;
+    ScopedStream stream;
+    stream->appendPlanned(value_);
+    return !stream->out().contentsEqual(exposed_);
+  }
+
+  /**
+   * @brief Write the value back if it changed
+   *
+   * @param key State key
+   */
+  template <typename KEY>
+  void flush(const KEY &key) {
+    // a const action does not compare the exposed values, it drops them
+    if (access_ == Exposed && StateCache::instance().read_only()) return;
+    if (!changed()) return;
+    if (access_ == Erased) {
+      del_state(key);
+      stored_ = false;
+      access_ = Clean;
+      exposed_.clear();
+    } else {
+      set_state(key, value_);
+      stored();
+    }
+  }
+
+ private:
+  T value_ = T();
+  bool stored_ = false;
+  Access access_ = Clean;
+  bytes exposed_;
+};
+
+}  // namespace db
+}  // namespace platon
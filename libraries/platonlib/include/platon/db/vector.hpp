@@ -0,0 +1,270 @@
+#pragma once
+
+#include <map>
+#include "platon/assert.hpp"
+#include "platon/db/state_key.hpp"
+#include "platon/db/tracked.hpp"
+#include "platon/name.hpp"
+#include "platon/storage.hpp"
+
+namespace platon {
+namespace db {
+/**
+ * @brief Dynamic array whose elements are stored under their own keys
+ *
+ * The length is kept in a slot of its own, each element under the key of
+ * its index. Elements are read from the blockchain when they are first used,
+ * push_back(), pop_back() and indexed access cost a constant number of state
+ * accesses whatever the length. Elements read through get() are never written
+ * back, at() and operator[] return a mutable reference and the element is
+ * written back only if it changed.
+ *
+ * @tparam TableName Vector name, in the same contract, the name should be
+ * unique
+ * @tparam T Element type
+ */
+template <Name::Raw TableName, typename T>
+class Vector {
+ public:
+  /**
+   * @brief Constant iterator, elements that are not cached are read without
+   * being cached
+   *
+   */
+  class const_iterator
+      : public std::iterator<std::forward_iterator_tag, const T> {
+   public:
+    friend bool operator==(const const_iterator& a, const const_iterator& b) {
+      return a.vector_ == b.vector_ && a.pos_ == b.pos_;
+    }
+    friend bool operator!=(const const_iterator& a, const const_iterator& b) {
+      return a.vector_ != b.vector_ || a.pos_ != b.pos_;
+    }
+
+   public:
+    /**
+     * @brief Construct a new Const iterator object
+     *
+     * @param vector Vector
+     * @param pos position
+     */
+    const_iterator(const Vector<TableName, T>* vector, size_t pos)
+        : vector_(vector), pos_(pos) {}
+
+    /**
+     * @brief Get the element value
+     *
+     * @return const T&
+     */
+    const T& operator*() {
+      value_ = vector_->get_const(pos_);
+      return value_;
+    }
+
+    const T* operator->() { return &**this; }
+
+    const_iterator& operator++() {
+      pos_++;
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator tmp(vector_, pos_++);
+      return tmp;
+    }
+
+   private:
+    const Vector<TableName, T>* vector_;
+    size_t pos_;
+    T value_;
+  };
+
+ public:
+  Vector() {}
+
+  Vector(const Vector<TableName, T>&) = delete;
+  Vector(const Vector<TableName, T>&&) = delete;
+  Vector<TableName, T>& operator=(const Vector<TableName, T>&) = delete;
+
+  /**
+   * @brief Destroy the Vector object. Refresh the changed elements and the
+   * length to blockchain
+   *
+   */
+  ~Vector() { Flush(); }
+
+  /**
+   * @brief Number of elements
+   *
+   * @return size_t
+   */
+  size_t size() const {
+    if (!size_loaded_) {
+      get_state(SizeKey(), stored_size_);
+      size_ = stored_size_;
+      size_loaded_ = true;
+    }
+    return size_;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  /**
+   * @brief Append an element, the elements already stored are not read
+   *
+   * @param value Element value
+   * Example:
+   *
+   * @code
+   * typedef platon::db::Vector<"log"_n, std::string> Log;
+   * Log log;
+   * log.push_back("hello");
+   * assert(log.back() == "hello");
+   * @endcode
+   */
+  void push_back(const T& value) {
+    size_t pos = size();
+    cache_[pos].modify() = value;
+    size_++;
+  }
+
+  /**
+   * @brief Remove the last element
+   *
+   */
+  void pop_back() {
+    platon_assert(size() > 0, "pop_back on empty vector");
+    size_--;
+    cache_[size_].erase();
+  }
+
+  /**
+   * @brief Get the specified position element, written back if it is changed
+   * through the returned reference
+   *
+   * @param pos Element position
+   * @return T& Element value
+   */
+  T& at(size_t pos) { return Load(pos).expose(); }
+
+  /**
+   * @brief Bracket operator
+   *
+   * @param pos position
+   * @return T& element
+   */
+  T& operator[](size_t pos) { return at(pos); }
+
+  /**
+   * @brief Get the specified position element for reading, it is cached but
+   * never written back
+   *
+   * @param pos Element position
+   * @return const T& Element value
+   */
+  const T& get(size_t pos) const { return Load(pos).get(); }
+
+  /**
+   * @brief Get the specified position element without caching it
+   *
+   * @param pos Element position
+   * @return T Element value
+   */
+  T get_const(size_t pos) const {
+    platon_assert(pos < size(), "out of range pos:", pos, "size:", size_);
+    auto iter = cache_.find(pos);
+    if (iter != cache_.end()) {
+      return iter->second.get();
+    }
+    T value;
+    get_state(ElementKey(pos), value);
+    return value;
+  }
+
+  T& back() { return at(size() - 1); }
+  const T& back() const { return get(size() - 1); }
+  T& front() { return at(0); }
+  const T& front() const { return get(0); }
+
+  /**
+   * @brief Visit at most @a count elements starting at @a first, without
+   * caching them. Long vectors can be walked a chunk per call.
+   *
+   * @param first First position
+   * @param count Maximum number of elements
+   * @param f Called with the position and the element value
+   * @return size_t The position after the last visited element
+   * Example:
+   *
+   * @code
+   * typedef platon::db::Vector<"log"_n, std::string> Log;
+   * Log log;
+   * size_t next = log.for_each(0, 100, [](size_t pos, const std::string& e) {
+   *   // ...
+   * });
+   * @endcode
+   */
+  template <typename F>
+  size_t for_each(size_t first, size_t count, F&& f) const {
+    if (first >= size()) return first;
+    size_t last = size() - first < count ? size() : first + count;
+    for (size_t pos = first; pos < last; pos++) {
+      f(pos, get_const(pos));
+    }
+    return last;
+  }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, size()); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+ public:
+  static const std::string kType;
+
+ private:
+  static constexpr Name::Raw kTag = "__vector__"_n;
+  typedef PrefixedKey<KeyPrefix<TableName, kTag>> SizeKey;
+  typedef PrefixedKey<KeyPrefix<TableName, kTag>, uint64_t> ElementKey;
+
+  /**
+   * @brief Cached element of the position, read from the blockchain on first
+   * use
+   *
+   */
+  Tracked<T>& Load(size_t pos) const {
+    platon_assert(pos < size(), "out of range pos:", pos, "size:", size_);
+    auto iter = cache_.find(pos);
+    if (iter != cache_.end()) {
+      return iter->second;
+    }
+    T value;
+    bool stored = get_state(ElementKey(pos), value) != 0;
+    return cache_.emplace(pos, Tracked<T>(std::move(value), stored))
+        .first->second;
+  }
+
+  /**
+   * @brief Refresh the changed elements and the length to blockchain
+   *
+   */
+  void Flush() {
+    for (auto& item : cache_) {
+      item.second.flush(ElementKey(item.first));
+    }
+    if (size_loaded_ && size_ != stored_size_) {
+      set_state(SizeKey(), uint64_t(size_));
+      stored_size_ = size_;
+    }
+  }
+
+  mutable std::map<uint64_t, Tracked<T>> cache_;
+  mutable uint64_t size_ = 0;
+  mutable uint64_t stored_size_ = 0;
+  mutable bool size_loaded_ = false;
+};
+
+template <Name::Raw TableName, typename T>
+const std::string Vector<TableName, T>::kType = "__vector__";
+}  // namespace db
+}  // namespace platon
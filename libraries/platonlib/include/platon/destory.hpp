@@ -15,6 +15,7 @@ bool platon_migrate_contract(Address &addr, const args_type &init_args,
   bytes gas_bytes = value_to_bytes(gas);
 
   // call platon_migrate
+  StateCache::instance().flush();
   return ::platon_migrate(addr.data(), init_args.data(), init_args.size(),
                           value_bytes.data(), value_bytes.size(),
                           gas_bytes.data(), gas_bytes.size()) == 0;
@@ -29,6 +30,7 @@ bool platon_migrate_contract(Address &addr, const Address &new_addr,
   bytes gas_bytes = value_to_bytes(gas);
 
   // call platon_migrate
+  StateCache::instance().flush();
   return ::platon_clone_migrate(new_addr.data(), addr.data(), init_args.data(),
                                 init_args.size(), value_bytes.data(),
                                 value_bytes.size(), gas_bytes.data(),
@@ -10,13 +10,19 @@
 #include <tuple>
 #include <type_traits>
 #include "RLP.h"
+#include "arena.hpp"
 #include "chain.hpp"
 #include "name.hpp"
 #include "panic.hpp"
 #include "rlp_extend.hpp"
+#include "rlp_size.hpp"
+#include "rlp_view.hpp"
+#include "state_cache.hpp"
 
 namespace platon {
 
+/// The input is never freed, arguments decoded as std::string_view,
+/// bytesConstRef or RLPView borrow it for the whole call.
 inline byte* get_input(size_t& len) {
   len = ::platon_get_input_length();
   byte* result = (byte*)malloc(len * sizeof(byte));
@@ -26,25 +32,25 @@ inline byte* get_input(size_t& len) {
 
 template <typename... Args>
 void get_para(RLP& rlp, std::tuple<Args...>& t) {
-  using tuple_args = typename std::remove_reference<decltype(t)>::type;
-  if (std::tuple_size<tuple_args>::value != rlp.itemCount() - 1) {
+  ScopedArena scope;
+  RLPIndex index(rlp, scope.arena());
+  if (sizeof...(Args) + 1 != index.size()) {
     platon::internal::platon_throw(
         "The number of method parameters does not match\n");
   }
 
   int vect_index = 1;
   boost::fusion::for_each(t, [&](auto& i) {
-    fetch(rlp[vect_index], i);
+    fetch(index[vect_index], i);
     vect_index++;
   });
 }
 
 template <typename T>
 void platon_return(const T& t) {
-  RLPStream rlp_stream;
-  rlp_stream.reserve(pack_size(t));
-  rlp_stream << t;
-  const bytesRef result = rlp_stream.out();
+  ScopedStream rlp_stream;
+  rlp_stream->appendPlanned(t);
+  const bytesRef result = rlp_stream->out();
   ::platon_return(result.data(), result.size());
 }
 
@@ -87,6 +93,46 @@ void execute_action(RLP& rlp, void (T::*func)(Args...)) {
   boost::mp11::tuple_apply(f2, args);
 }
 
+/**
+ * Execute a const action handler read only
+ *
+ * CONST actions are const member functions, platon-cpp enforces it. They drop
+ * every state write, including the ones of storage objects destroyed after
+ * the action returns. A query only pays for its reads.
+ *
+ * @tparam T - The contract class that has the correponding action handler
+ * @tparam Args - The arguments that the action handler accepts
+ * @param func - The const action handler
+ */
+template <typename T, typename R, typename... Args>
+void execute_action(RLP& rlp, R (T::*func)(Args...) const) {
+  StateCache::instance().set_read_only();
+  std::tuple<std::decay_t<Args>...> args;
+  get_para(rlp, args);
+
+  T inst;
+
+  auto f2 = [&](auto... a) {
+    R&& t = ((&inst)->*func)(a...);
+    platon_return<R>(t);
+  };
+
+  boost::mp11::tuple_apply(f2, args);
+}
+
+template <typename T, typename... Args>
+void execute_action(RLP& rlp, void (T::*func)(Args...) const) {
+  StateCache::instance().set_read_only();
+  std::tuple<std::decay_t<Args>...> args;
+  get_para(rlp, args);
+
+  T inst;
+
+  auto f2 = [&](auto... a) { ((&inst)->*func)(a...); };
+
+  boost::mp11::tuple_apply(f2, args);
+}
+
 // Helper macro for PLATON_DISPATCH_INTERNAL
 #define PLATON_DISPATCH_INTERNAL(r, OP, elem)                        \
   else if (method == platon::name_value(BOOST_PP_STRINGIZE(elem))) { \
@@ -132,6 +178,7 @@ void execute_action(RLP& rlp, void (T::*func)(Args...)) {
     }                                                        \
   }                                                          \
   void invoke(void) {                                        \
+    platon::StateCache::instance().enable();                 \
     __wasm_call_ctors();                                     \
     _invoke();                                               \
     __funcs_on_exit();                                       \
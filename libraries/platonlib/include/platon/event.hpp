@@ -152,22 +152,22 @@
         _func9(M_CAT(ARG_POS, total)(__VA_ARGS__), total, __VA_ARGS__)
 
 #define PLATON_EVENT0(NAME, ...)                  \
-  EVENT void NAME(VA_F(__VA_ARGS__)) {            \
+  EVENT void NAME(VA_F(__VA_ARGS__)) const {      \
     platon::emit_event0(#NAME PA_F(__VA_ARGS__)); \
   }
 
 #define PLATON_EMIT_EVENT0(NAME, ...) NAME(__VA_ARGS__)
 
-#define PLATON_EVENT1(NAME, TOPIC_TYPE, ...)              \
-  EVENT1 void NAME(TOPIC_TYPE topic _VA_F(__VA_ARGS__)) { \
-    platon::emit_event1(#NAME, topic PA_F(__VA_ARGS__));  \
+#define PLATON_EVENT1(NAME, TOPIC_TYPE, ...)                    \
+  EVENT1 void NAME(TOPIC_TYPE topic _VA_F(__VA_ARGS__)) const { \
+    platon::emit_event1(#NAME, topic PA_F(__VA_ARGS__));        \
   }
 
 #define PLATON_EMIT_EVENT1(NAME, ...) NAME(__VA_ARGS__)
 
 #define PLATON_EVENT2(NAME, TOPIC_TYPE1, TOPIC_TYPE2, ...)        \
   EVENT2 void NAME(TOPIC_TYPE1 topic1,                            \
-                   TOPIC_TYPE2 topic2 _VA_F(__VA_ARGS__)) {       \
+                   TOPIC_TYPE2 topic2 _VA_F(__VA_ARGS__)) const { \
     platon::emit_event2(#NAME, topic1, topic2 PA_F(__VA_ARGS__)); \
   }
 
@@ -175,7 +175,7 @@
 
 #define PLATON_EVENT3(NAME, TOPIC_TYPE1, TOPIC_TYPE2, TOPIC_TYPE3, ...)   \
   EVENT3 void NAME(TOPIC_TYPE1 topic1, TOPIC_TYPE2 topic2,                \
-                   TOPIC_TYPE3 topic3 _VA_F(__VA_ARGS__)) {               \
+                   TOPIC_TYPE3 topic3 _VA_F(__VA_ARGS__)) const {         \
     platon::emit_event3(#NAME, topic1, topic2, topic3 PA_F(__VA_ARGS__)); \
   }
 
@@ -210,10 +210,9 @@ bytes event_bytes_data_convert(const T &data) {
 
 template <typename T>
 bytes event_other_data_convert(const T &data) {
-  RLPStream stream;
-  stream.reserve(pack_size(data));
-  stream << data;
-  const bytesRef rlp_result = stream.out();
+  ScopedStream stream;
+  stream->appendPlanned(data);
+  const bytesRef rlp_result = stream->out();
   bytes result = rlp_result.toBytes();
   if (result.size() > 32) {
     result.resize(32);
@@ -310,8 +309,7 @@ typename event_topic_type<T, is_number>::type event_data_convert(
 template <typename... Args>
 inline void event_args(RLPStream &stream, const Args &... args) {
   std::tuple<Args...> tuple_args = std::make_tuple(args...);
-  stream.reserve(pack_size(tuple_args));
-  stream << tuple_args;
+  stream.appendPlanned(tuple_args);
   //  return stream.out();
 }
 
@@ -324,9 +322,9 @@ inline void event_args(RLPStream &stream, const Args &... args) {
  */
 template <typename... Args>
 inline void emit_event(const Args &... args) {
-  RLPStream stream;
-  event_args(stream, args...);
-  bytesRef topic_data = stream.out();
+  ScopedStream stream;
+  event_args(*stream, args...);
+  bytesRef topic_data = stream->out();
   ::platon_event(NULL, 0, topic_data.data(), topic_data.size());
 }
 
@@ -340,14 +338,14 @@ inline void emit_event(const Args &... args) {
  */
 template <typename... Args>
 inline void emit_event0(const std::string &name, const Args &... args) {
-  RLPStream stream(1);
+  ScopedStream stream(1);
   auto event_sign = event_data_convert(name);
-  stream.reserve(pack_size(event_sign));
-  stream << event_sign;
-  const bytesRef topic_data = stream.out();
-  RLPStream args_stream;
-  event_args(args_stream, args...);
-  bytesRef args_data = args_stream.out();
+  stream->reserve(pack_size(event_sign));
+  *stream << event_sign;
+  const bytesRef topic_data = stream->out();
+  ScopedStream args_stream;
+  event_args(*args_stream, args...);
+  bytesRef args_data = args_stream->out();
   ::platon_event(topic_data.data(), topic_data.size(), args_data.data(),
                  args_data.size());
 }
@@ -364,17 +362,17 @@ inline void emit_event0(const std::string &name, const Args &... args) {
 template <class Topic, typename... Args>
 inline void emit_event1(const std::string &name, const Topic &topic,
                         const Args &... args) {
-  RLPStream stream(2);
+  ScopedStream stream(2);
   auto event_sign = event_data_convert(name);
   auto topic1_data = event_data_convert(topic);
   RLPSize rlps;
   rlps << event_sign << topic1_data;
-  stream.reserve(rlps.size());
-  stream << event_sign << topic1_data;
-  const bytesRef topic_data = stream.out();
-  RLPStream args_stream;
-  event_args(args_stream, args...);
-  bytesRef rlp_data = args_stream.out();
+  stream->reserve(rlps.size());
+  *stream << event_sign << topic1_data;
+  const bytesRef topic_data = stream->out();
+  ScopedStream args_stream;
+  event_args(*args_stream, args...);
+  bytesRef rlp_data = args_stream->out();
   ::platon_event(topic_data.data(), topic_data.size(), rlp_data.data(),
                  rlp_data.size());
 }
@@ -392,18 +390,18 @@ inline void emit_event1(const std::string &name, const Topic &topic,
 template <class Topic1, class Topic2, typename... Args>
 inline void emit_event2(const std::string &name, const Topic1 &topic1,
                         const Topic2 &topic2, const Args &... args) {
-  RLPStream stream(3);
+  ScopedStream stream(3);
   auto event_sign = event_data_convert(name);
   auto topic1_data = event_data_convert(topic1);
   auto topic2_data = event_data_convert(topic2);
   RLPSize rlps;
   rlps << event_sign << topic1_data << topic2_data;
-  stream.reserve(rlps.size());
-  stream << event_sign << topic1_data << topic2_data;
-  const bytesRef topic_data = stream.out();
-  RLPStream args_stream;
-  event_args(args_stream, args...);
-  bytesRef rlp_data = args_stream.out();
+  stream->reserve(rlps.size());
+  *stream << event_sign << topic1_data << topic2_data;
+  const bytesRef topic_data = stream->out();
+  ScopedStream args_stream;
+  event_args(*args_stream, args...);
+  bytesRef rlp_data = args_stream->out();
   ::platon_event(topic_data.data(), topic_data.size(), rlp_data.data(),
                  rlp_data.size());
 }
@@ -423,19 +421,19 @@ template <class Topic1, class Topic2, class Topic3, typename... Args>
 inline void emit_event3(const std::string &name, const Topic1 &topic1,
                         const Topic2 &topic2, const Topic3 &topic3,
                         const Args &... args) {
-  RLPStream stream(4);
+  ScopedStream stream(4);
   auto event_sign = event_data_convert(name);
   auto topic1_data = event_data_convert(topic1);
   auto topic2_data = event_data_convert(topic2);
   auto topic3_data = event_data_convert(topic3);
   RLPSize rlps;
   rlps << event_sign << topic1_data << topic2_data << topic3_data;
-  stream.reserve(rlps.size());
-  stream << event_sign << topic1_data << topic2_data << topic3_data;
-  const bytesRef topic_data = stream.out();
-  RLPStream args_stream;
-  event_args(args_stream, args...);
-  bytesRef rlp_data = args_stream.out();
+  stream->reserve(rlps.size());
+  *stream << event_sign << topic1_data << topic2_data << topic3_data;
+  const bytesRef topic_data = stream->out();
+  ScopedStream args_stream;
+  event_args(*args_stream, args...);
+  bytesRef rlp_data = args_stream->out();
   ::platon_event(topic_data.data(), topic_data.size(), rlp_data.data(),
                  rlp_data.size());
 }
@@ -8,8 +8,11 @@
 #include "platon/contract.hpp"
 #include "platon/cross_call.hpp"
 #include "platon/db/array.hpp"
+#include "platon/db/deque.hpp"
 #include "platon/db/map.hpp"
 #include "platon/db/multi_index.hpp"
+#include "platon/db/set.hpp"
+#include "platon/db/vector.hpp"
 #include "platon/destory.hpp"
 #include "platon/dispatcher.hpp"
 #include "platon/event.hpp"
@@ -18,6 +21,8 @@
 #include "platon/print.hpp"
 #include "platon/rlp_extend.hpp"
 #include "platon/rlp_serialize.hpp"
+#include "platon/rlp_view.hpp"
+#include "platon/state_cache.hpp"
 #include "platon/storage.hpp"
 #include "platon/storagetype.hpp"
 #include "platon/create.hpp"
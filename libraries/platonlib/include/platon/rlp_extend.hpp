@@ -102,10 +102,12 @@ inline void fetch(const RLP& rlp, bytes& value) { value = rlp.toBytes(); }
 template <class T>
 inline void fetch(const RLP& rlp, std::vector<T>& ret) {
   if (rlp.isList()) {
-    ret.reserve(rlp.itemCount());
-    for (auto const& i : rlp) {
+    ScopedArena scope;
+    RLPIndex index(rlp, scope.arena());
+    ret.reserve(ret.size() + index.size());
+    for (size_t i = 0; i < index.size(); ++i) {
       T one;
-      fetch(i, one);
+      fetch(index[i], one);
       ret.push_back(std::move(one));
     }
   } else {
@@ -167,12 +169,17 @@ inline void fetch(const RLP& rlp, std::pair<T, U>& ret) {
 
 template <class T, size_t N>
 inline void fetch(const RLP& rlp, std::array<T, N>& ret) {
-  if (rlp.itemCountStrict() != N) {
+  if (!rlp.isList()) {
+    internal::platon_throw("bad cast");
+  }
+  ScopedArena scope;
+  RLPIndex index(rlp, scope.arena());
+  if (index.size() != N) {
     internal::platon_throw("bad cast");
   }
   for (size_t i = 0; i < N; ++i) {
     T one;
-    fetch(rlp[i], one);
+    fetch(index[i], one);
     ret[i] = std::move(one);
   }
 }
@@ -180,10 +187,13 @@ inline void fetch(const RLP& rlp, std::array<T, N>& ret) {
 template <class T, class U>
 inline void fetch(const RLP& rlp, std::map<T, U>& ret) {
   if (rlp.isList()) {
-    for (auto const& i : rlp) {
+    ScopedArena scope;
+    RLPIndex index(rlp, scope.arena());
+    // maps are encoded in key order, each entry goes right after the last one
+    for (size_t i = 0; i < index.size(); ++i) {
       std::pair<T, U> one;
-      fetch(i, one);
-      ret.insert(std::move(one));
+      fetch(index[i], one);
+      ret.emplace_hint(ret.end(), std::move(one));
     }
   } else {
     internal::platon_throw("bad cast");
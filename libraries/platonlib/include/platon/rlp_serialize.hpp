@@ -4,18 +4,24 @@
 #include <boost/preprocessor/seq/for_each.hpp>
 #include <boost/preprocessor/seq/seq.hpp>
 #include <boost/preprocessor/seq/size.hpp>
+#include <boost/preprocessor/seq/transform.hpp>
 #include <boost/preprocessor/stringize.hpp>
+#include <type_traits>
 #include <vector>
 
 #include "platon/RLP.h"
 #include "platon/common.h"
 #include "platon/rlp_extend.hpp"
 #include "platon/rlp_size.hpp"
+#include "platon/rlp_view.hpp"
 
 #define PLATON_REFLECT_MEMBER_NUMBER(r, OP, elem) items_number++;
 
 #define PLATON_REFLECT_MEMBER_OP_INPUT(r, OP, elem) OP t.elem
 
+#define PLATON_REFLECT_MEMBER_TYPE(s, PTR, elem) \
+  std::decay_t<decltype(PTR->elem)>
+
 #define PLATON_REFLECT_MEMBER_OP_OUTPUT(r, OP, elem) \
   OP(rlp[vect_index], t.elem);                       \
   vect_index++;
@@ -30,14 +36,21 @@
  *  @param MEMBERS - a sequence of member names.  (field1)(field2)(field3)
  */
 #define PLATON_SERIALIZE(TYPE, MEMBERS)                                      \
+  friend constexpr size_t platon_max_pack_size(const TYPE* t) {              \
+    return platon::rlp_list_max_size<BOOST_PP_SEQ_ENUM(                      \
+        BOOST_PP_SEQ_TRANSFORM(PLATON_REFLECT_MEMBER_TYPE, t, MEMBERS))>();  \
+  }                                                                          \
+  friend constexpr bool platon_rlp_borrows(const TYPE* t) {                  \
+    return platon::rlp_list_borrows<BOOST_PP_SEQ_ENUM(                       \
+        BOOST_PP_SEQ_TRANSFORM(PLATON_REFLECT_MEMBER_TYPE, t, MEMBERS))>();  \
+  }                                                                          \
   friend platon::RLPStream& operator<<(platon::RLPStream& rlp,               \
                                        const TYPE& t) {                      \
+    if (platon::max_pack_size<TYPE>() == 0 && !rlp.hasListPlan())            \
+      return rlp.appendPlanned(t);                                           \
     size_t items_number = 0;                                                 \
     BOOST_PP_SEQ_FOR_EACH(PLATON_REFLECT_MEMBER_NUMBER, <<, MEMBERS)         \
     rlp.appendList(items_number);                                            \
-    platon::RLPSize rlps;                                                    \
-    rlps BOOST_PP_SEQ_FOR_EACH(PLATON_REFLECT_MEMBER_OP_INPUT, <<, MEMBERS); \
-    rlp.reserve(rlps.size());                                                \
     return rlp BOOST_PP_SEQ_FOR_EACH(PLATON_REFLECT_MEMBER_OP_INPUT, <<,     \
                                      MEMBERS);                               \
   }                                                                          \
@@ -64,15 +77,21 @@
  *  @param MEMBERS - a sequence of member names.  (field1)(field2)(field3)
  */
 #define PLATON_SERIALIZE_DERIVED(TYPE, BASE, MEMBERS)                        \
+  friend constexpr size_t platon_max_pack_size(const TYPE* t) {              \
+    return platon::rlp_list_max_size<BASE, BOOST_PP_SEQ_ENUM(                \
+        BOOST_PP_SEQ_TRANSFORM(PLATON_REFLECT_MEMBER_TYPE, t, MEMBERS))>();  \
+  }                                                                          \
+  friend constexpr bool platon_rlp_borrows(const TYPE* t) {                  \
+    return platon::rlp_list_borrows<BASE, BOOST_PP_SEQ_ENUM(                 \
+        BOOST_PP_SEQ_TRANSFORM(PLATON_REFLECT_MEMBER_TYPE, t, MEMBERS))>();  \
+  }                                                                          \
   friend platon::RLPStream& operator<<(platon::RLPStream& rlp,               \
                                        const TYPE& t) {                      \
+    if (platon::max_pack_size<TYPE>() == 0 && !rlp.hasListPlan())            \
+      return rlp.appendPlanned(t);                                           \
     size_t items_number = 1;                                                 \
     BOOST_PP_SEQ_FOR_EACH(PLATON_REFLECT_MEMBER_NUMBER, <<, MEMBERS)         \
     rlp.appendList(items_number);                                            \
-    platon::RLPSize rlps;                                                    \
-    rlps << static_cast<const BASE&>(t);                                     \
-    rlps BOOST_PP_SEQ_FOR_EACH(PLATON_REFLECT_MEMBER_OP_INPUT, <<, MEMBERS); \
-    rlp.reserve(rlps.size());                                                \
     rlp << static_cast<const BASE&>(t);                                      \
     return rlp BOOST_PP_SEQ_FOR_EACH(PLATON_REFLECT_MEMBER_OP_INPUT, <<,     \
                                      MEMBERS);                               \
@@ -8,6 +8,8 @@
 #include <map>
 #include <set>
 #include <stack>
+#include <string_view>
+#include <type_traits>
 #include <unordered_set>
 #include <vector>
 
@@ -16,6 +18,40 @@
 
 namespace platon {
 
+namespace rlp_detail {
+/// Stack of size_t whose first levels live inside the object, so that
+/// sizing shallow data never touches the heap.
+class SizeStack {
+ public:
+  static constexpr size_t inline_depth = 8;
+
+  SizeStack() : count_(0) {}
+
+  size_t size() const { return count_; }
+  bool empty() const { return count_ == 0; }
+  size_t& top() {
+    return count_ <= inline_depth ? inline_[count_ - 1] : overflow_.back();
+  }
+  void push(size_t value) {
+    if (count_ < inline_depth) {
+      inline_[count_] = value;
+    } else {
+      overflow_.push_back(value);
+    }
+    ++count_;
+  }
+  void pop() {
+    if (count_ > inline_depth) overflow_.pop_back();
+    --count_;
+  }
+
+ private:
+  size_t inline_[inline_depth];
+  size_t count_;
+  std::vector<size_t> overflow_;
+};
+}  // namespace rlp_detail
+
 class RLPSize {
  public:
   enum ListFlag {
@@ -24,7 +60,13 @@ class RLPSize {
   };
 
  public:
-  explicit RLPSize(size_t init_size = 0) : size_(init_size), pending_() {}
+  explicit RLPSize(size_t init_size = 0)
+      : size_(init_size), pending_(), list_sizes_(nullptr) {}
+
+  /// Also records the payload size of every list, in the order the lists
+  /// start, as an array of size_t in @a list_sizes.
+  explicit RLPSize(BytesBuffer& list_sizes)
+      : size_(0), pending_(), list_sizes_(&list_sizes) {}
 
   const size_t size() const { return size_; }
 
@@ -75,6 +117,11 @@ class RLPSize {
       assert(pending_.size() > 0);
       size_t list_size = pending_.top();
       pending_.pop();
+      if (list_sizes_ != nullptr) {
+        reinterpret_cast<size_t*>(list_sizes_->data())[slots_.top()] =
+            list_size;
+        slots_.pop();
+      }
       if (list_size < c_rlpListImmLenCount) {
         (list_size += 1);
       } else {
@@ -88,6 +135,19 @@ class RLPSize {
       }
     } else {
       pending_.push(0);
+      if (list_sizes_ != nullptr) {
+        slots_.push(record_list(0));
+      }
+    }
+    return *this;
+  }
+
+  /// Accounts for @a size bytes of already encoded RLP data.
+  RLPSize& append_raw(size_t size) {
+    if (pending_.size() > 0) {
+      pending_.top() += size;
+    } else {
+      size_ += size;
     }
     return *this;
   }
@@ -97,20 +157,42 @@ class RLPSize {
   static ListFlag list_end() { return ListFlag::End; }
 
  private:
-  RLPSize& append(bool b) {
-    unsigned s = b ? 1 : 0;
-    return append(bigint(s));
-  }
+  RLPSize& append(bool b) { return append_unsigned(uint8_t(b ? 1 : 0)); }
+
+  RLPSize& append(uint8_t s) { return append_unsigned(s); }
 
-  RLPSize& append(uint8_t s) { return append(bigint(s)); }
+  RLPSize& append(uint16_t s) { return append_unsigned(s); }
 
-  RLPSize& append(uint16_t s) { return append(bigint(s)); }
+  RLPSize& append(uint32_t s) { return append_unsigned(s); }
 
-  RLPSize& append(uint32_t s) { return append(bigint(s)); }
+  RLPSize& append(uint64_t s) { return append_unsigned(s); }
+
+  template <class T>
+  RLPSize& append_unsigned(T s) {
+    size_t size = 1;
+    if (s >= c_rlpDataImmLenStart) {
+      size += 8 - (__builtin_clzll(uint64_t(s)) >> 3);
+    }
+
+    if (pending_.size() > 0) {
+      pending_.top() += size;
+    } else {
+      size_ += size;
+    }
+    return *this;
+  }
 
-  RLPSize& append(uint64_t s) { return append(bigint(s)); }
+  template <class T>
+  RLPSize& append_signed(T c) {
+    int64_t l = c;
+    return append_unsigned(uint64_t((uint64_t(l) << 1) ^ uint64_t(l >> 63)));
+  }
 
   RLPSize& append(bigint s) {
+    if (uint64_t(s >> 64) == 0) {
+      return append_unsigned(uint64_t(s));
+    }
+
     size_t size = 0;
     if (s == 0 || s < c_rlpDataImmLenStart) {
       size = 1;
@@ -131,15 +213,15 @@ class RLPSize {
     return *this;
   }
 
-  RLPSize& append(int8_t s) { return append(int128_t(s)); }
+  RLPSize& append(int8_t s) { return append_signed(s); }
 
-  RLPSize& append(int16_t s) { return append(int128_t(s)); }
+  RLPSize& append(int16_t s) { return append_signed(s); }
 
-  RLPSize& append(int c) { return append(int128_t(c)); }
+  RLPSize& append(int c) { return append_signed(c); }
 
-  RLPSize& append(int32_t c) { return append(int128_t(c)); }
+  RLPSize& append(int32_t c) { return append_signed(c); }
 
-  RLPSize& append(int64_t c) { return append(int128_t(c));}
+  RLPSize& append(int64_t c) { return append_signed(c); }
 
   RLPSize& append(int128_t c) {
     uint128_t i = uint128_t((c << 1) ^ (c >> 127));
@@ -156,44 +238,28 @@ class RLPSize {
     return append(i);
   }
 
-  RLPSize& append(const bytes& s) {
-    size_t total = 0;
-    if (s.empty()) {
-      total = 1;
-    } else {
-      const byte* d = s.data();
-      size_t size = s.size();
-      if (size == 1 && *d < c_rlpDataImmLenStart) {
-        total = 1;
-      } else if (size < c_rlpDataImmLenCount) {
-        total = size + 1;
-      } else {
-        total = size + bytesRequired(size) + 1;
-      }
-    }
+  RLPSize& append(const bytes& s) { return append_data(s.data(), s.size()); }
 
-    if (pending_.size() > 0) {
-      pending_.top() += total;
-    } else {
-      size_ += total;
-    }
-    return *this;
+  RLPSize& append(const std::string& s) {
+    return append_data(reinterpret_cast<const byte*>(s.data()), s.size());
   }
 
-  RLPSize& append(const std::string& s) {
+  RLPSize& append(std::string_view s) {
+    return append_data(reinterpret_cast<const byte*>(s.data()), s.size());
+  }
+
+  RLPSize& append(bytesConstRef s) { return append_data(s.data(), s.size()); }
+
+  RLPSize& append_data(const byte* d, size_t size) {
     size_t total = 0;
-    if (s.empty()) {
+    if (size == 0) {
+      total = 1;
+    } else if (size == 1 && *d < c_rlpDataImmLenStart) {
       total = 1;
+    } else if (size < c_rlpDataImmLenCount) {
+      total = size + 1;
     } else {
-      const byte* d = reinterpret_cast<const byte*>(s.data());
-      size_t size = s.size();
-      if (size == 1 && *d < c_rlpDataImmLenStart) {
-        total = 1;
-      } else if (size < c_rlpDataImmLenCount) {
-        total = size + 1;
-      } else {
-        total = size + bytesRequired(size) + 1;
-      }
+      total = size + bytesRequired(size) + 1;
     }
 
     if (pending_.size() > 0) {
@@ -206,8 +272,9 @@ class RLPSize {
 
   template <unsigned N>
   RLPSize& append(FixedHash<N> s) {
+    // RLPStream always writes the N bytes, even for an all zero hash
     size_t size = 0;
-    if (!s) {
+    if (N == 1 && s[0] < c_rlpDataImmLenStart) {
       size = 1;
     } else if (N < c_rlpDataImmLenCount) {
       size = N + 1;
@@ -321,7 +388,17 @@ class RLPSize {
     return *this;
   }
 
+  size_t record_list(size_t size) {
+    size_t slot = list_sizes_->size() / sizeof(size_t);
+    const byte* data = reinterpret_cast<const byte*>(&size);
+    list_sizes_->append(data, data + sizeof(size_t));
+    return slot;
+  }
+
   RLPSize& AppendEmptyList() {
+    if (list_sizes_ != nullptr) {
+      record_list(0);
+    }
     if (pending_.size() > 0) {
       pending_.top()++;
     } else {
@@ -332,7 +409,9 @@ class RLPSize {
 
  private:
   size_t size_;
-  std::stack<size_t> pending_;
+  rlp_detail::SizeStack pending_;
+  BytesBuffer* list_sizes_;
+  rlp_detail::SizeStack slots_;
 };
 
 template <class T>
@@ -341,4 +420,105 @@ size_t pack_size(const T& t) {
   rlps << t;
   return rlps.size();
 }
+
+namespace rlp_detail {
+constexpr size_t bytes_required(size_t size) {
+  size_t count = 0;
+  for (; size != 0; size >>= 8) ++count;
+  return count;
+}
+
+constexpr size_t header_size(size_t payload) {
+  return payload < c_rlpDataImmLenCount ? 1 : 1 + bytes_required(payload);
+}
+}  // namespace rlp_detail
+
+/**
+ * @brief Upper bound of the RLP encoded size of a type, 0 when the encoded
+ * size is not bounded
+ *
+ * Types declared with PLATON_SERIALIZE get their bound from their member
+ * list.
+ */
+template <class T, class Enable = void>
+struct rlp_max_size : std::integral_constant<size_t, 0> {};
+
+template <class T>
+constexpr size_t max_pack_size() {
+  return rlp_max_size<std::decay_t<T>>::value;
+}
+
+/**
+ * @brief Upper bound of the RLP encoded size of a list whose items have the
+ * given types, 0 when one of them is not bounded
+ */
+template <class... Ts>
+constexpr size_t rlp_list_max_size() {
+  if constexpr (((max_pack_size<Ts>() == 0) || ...)) {
+    return 0;
+  } else {
+    constexpr size_t payload = (size_t(0) + ... + max_pack_size<Ts>());
+    return payload + rlp_detail::header_size(payload);
+  }
+}
+
+// integers are written with their significant bytes only, signed ones after
+// a zigzag mapping of the same width
+template <class T>
+struct rlp_max_size<
+    T, std::enable_if_t<std::is_integral<T>::value ||
+                        std::is_floating_point<T>::value ||
+                        std::is_same<T, u128>::value ||
+                        std::is_same<T, int128_t>::value>>
+    : std::integral_constant<size_t, std::is_same<T, bool>::value
+                                         ? 1
+                                         : sizeof(T) + 1> {};
+
+template <unsigned N>
+struct rlp_max_size<FixedHash<N>>
+    : std::integral_constant<size_t, N + rlp_detail::header_size(N)> {};
+
+template <class T, size_t N>
+struct rlp_max_size<std::array<T, N>>
+    : std::integral_constant<
+          size_t, (N != 0 && max_pack_size<T>() == 0)
+                      ? 0
+                      : N * max_pack_size<T>() +
+                            rlp_detail::header_size(N * max_pack_size<T>())> {
+};
+
+template <class T, class U>
+struct rlp_max_size<std::pair<T, U>>
+    : std::integral_constant<size_t, rlp_list_max_size<T, U>()> {};
+
+template <class... Ts>
+struct rlp_max_size<std::tuple<Ts...>>
+    : std::integral_constant<size_t, rlp_list_max_size<Ts...>()> {};
+
+template <class T>
+struct rlp_max_size<T, std::void_t<decltype(platon_max_pack_size(
+                           static_cast<const T*>(nullptr)))>>
+    : std::integral_constant<size_t, platon_max_pack_size(
+                                         static_cast<const T*>(nullptr))> {};
+
+template <class _T>
+inline RLPStream& RLPStream::appendPlanned(_T const& _t) {
+  if (hasListPlan()) {
+    return *this << _t;
+  }
+
+  // a bounded value is short, closing its lists costs less than sizing it
+  if constexpr (max_pack_size<_T>() != 0) {
+    reserve(m_out.size() + max_pack_size<_T>());
+    return *this << _t;
+  }
+
+  dropListPlan();
+  RLPSize rlps(m_listPlan);
+  rlps << _t;
+  reserve(m_out.size() + rlps.size());
+  *this << _t;
+  dropListPlan();
+  return *this;
+}
 }  // namespace platon
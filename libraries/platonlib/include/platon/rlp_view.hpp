@@ -0,0 +1,191 @@
+#pragma once
+
+#include <array>
+#include <list>
+#include <map>
+#include <set>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "RLP.h"
+#include "panic.hpp"
+#include "rlp_extend.hpp"
+#include "rlp_size.hpp"
+
+namespace platon {
+
+/**
+ * @brief Read only view over an RLP list whose items are decoded on access
+ *
+ * The view borrows the encoded data, nothing is copied until an item is read.
+ * Items are decoded with fetch(), reading them in ascending order is the
+ * cheapest. Encoding a view writes the borrowed list back unchanged, which
+ * makes forwarding decoded arguments free of any re-encoding.
+ *
+ * Example:
+ *
+ * @code
+  void add_all(const RLPView<std::string_view> &names) {
+    for (std::string_view name : names) {
+      // ...
+    }
+  }
+ * @endcode
+ *
+ * @tparam T Item type
+ */
+template <class T>
+class RLPView {
+ public:
+  class iterator {
+   public:
+    using value_type = T;
+
+    explicit iterator(RLP::iterator it) : it_(it) {}
+
+    T operator*() const {
+      T one;
+      fetch(*it_, one);
+      return one;
+    }
+    iterator &operator++() {
+      ++it_;
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator ret = *this;
+      ++it_;
+      return ret;
+    }
+    bool operator==(const iterator &other) const { return it_ == other.it_; }
+    bool operator!=(const iterator &other) const { return it_ != other.it_; }
+
+   private:
+    RLP::iterator it_;
+  };
+
+  RLPView() {}
+
+  /**
+   * @brief Construct a view over an RLP list
+   *
+   * @param rlp The list, its data must outlive the view
+   */
+  explicit RLPView(const RLP &rlp) : rlp_(rlp) {
+    if (!rlp.isList()) internal::platon_throw("bad cast");
+  }
+
+  /**
+   * @brief Number of items in the list
+   *
+   * @return size_t The item count
+   */
+  size_t size() const { return rlp_.itemCount(); }
+
+  bool empty() const { return size() == 0; }
+
+  /**
+   * @brief Decode the item at @a index
+   *
+   * @param index Item index
+   * @return T The decoded item
+   */
+  T operator[](size_t index) const {
+    T one;
+    fetch(rlp_[index], one);
+    return one;
+  }
+
+  iterator begin() const { return iterator(rlp_.begin()); }
+  iterator end() const { return iterator(rlp_.end()); }
+
+  /// The borrowed list, empty for a default constructed view.
+  const RLP &rlp() const { return rlp_; }
+
+ private:
+  RLP rlp_;
+};
+
+// std::string_view and bytesConstRef are fetched through the RLP conversion
+// operators, like std::string and bytes
+template <class T>
+inline void fetch(const RLP &rlp, RLPView<T> &value) {
+  value = RLPView<T>(rlp);
+}
+
+template <class T>
+inline RLPStream &operator<<(RLPStream &rlp, const RLPView<T> &view) {
+  if (view.rlp().isNull()) return rlp.appendList(0);
+  return rlp.appendRaw(view.rlp().data());
+}
+
+template <class T>
+inline RLPSize &operator<<(RLPSize &rlps, const RLPView<T> &view) {
+  if (view.rlp().isNull()) return rlps.append_raw(1);
+  return rlps.append_raw(view.rlp().data().size());
+}
+
+/**
+ * @brief Whether a decoded T points into the data it was decoded from
+ *
+ * Such values need the encoded data to stay alive after decoding. Types
+ * declared with PLATON_SERIALIZE borrow when one of their members does.
+ */
+template <class T, class Enable = void>
+struct rlp_borrows : std::false_type {};
+
+template <class T>
+constexpr bool rlp_borrows_v = rlp_borrows<std::decay_t<T>>::value;
+
+template <>
+struct rlp_borrows<std::string_view> : std::true_type {};
+
+template <>
+struct rlp_borrows<bytesConstRef> : std::true_type {};
+
+template <>
+struct rlp_borrows<RLP> : std::true_type {};
+
+template <class T>
+struct rlp_borrows<RLPView<T>> : std::true_type {};
+
+template <class T>
+struct rlp_borrows<std::vector<T>> : rlp_borrows<T> {};
+
+template <class T>
+struct rlp_borrows<std::list<T>> : rlp_borrows<T> {};
+
+template <class T>
+struct rlp_borrows<std::set<T>> : rlp_borrows<T> {};
+
+template <class T, size_t N>
+struct rlp_borrows<std::array<T, N>> : rlp_borrows<T> {};
+
+template <class T, class U>
+struct rlp_borrows<std::pair<T, U>>
+    : std::integral_constant<bool, rlp_borrows_v<T> || rlp_borrows_v<U>> {};
+
+template <class T, class U>
+struct rlp_borrows<std::map<T, U>>
+    : std::integral_constant<bool, rlp_borrows_v<T> || rlp_borrows_v<U>> {};
+
+template <class... Ts>
+struct rlp_borrows<std::tuple<Ts...>>
+    : std::integral_constant<bool, (rlp_borrows_v<Ts> || ...)> {};
+
+template <class T>
+struct rlp_borrows<T, std::void_t<decltype(platon_rlp_borrows(
+                          static_cast<const T *>(nullptr)))>>
+    : std::integral_constant<bool, platon_rlp_borrows(
+                                       static_cast<const T *>(nullptr))> {};
+
+/// Whether any of the types borrows, for the PLATON_SERIALIZE member lists.
+template <class... Ts>
+constexpr bool rlp_list_borrows() {
+  return (rlp_borrows_v<Ts> || ...);
+}
+
+}  // namespace platon
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+
+#include "chain.hpp"
+#include "common.h"
+#include "panic.hpp"
+
+/// Stack buffer used to read a state value with a single host call, longer
+/// values need a length query and a second read.
+#ifndef PLATON_STATE_READ_SIZE
+#define PLATON_STATE_READ_SIZE 128
+#endif
+
+/// Define PLATON_CONST_WRITE_CHECK to panic with a debug message when a
+/// CONST action writes the state, instead of silently dropping the write.
+
+namespace platon {
+
+/**
+ * @brief Read-through, write-back cache of the contract state
+ *
+ * Once enabled, set_state, get_state, has_state and del_state, and every
+ * container built on them, go through the cache. Each key is read from the
+ * chain at most once, and repeated writes to a key are combined and written
+ * once by flush(). Keys are flushed in ascending order.
+ *
+ * PLATON_DISPATCH enables the cache before the global objects are
+ * constructed. The flush is registered with atexit at that point, so
+ * __funcs_on_exit runs it after every global storage object has been
+ * destroyed. Calls into other contracts flush the cache first, because they
+ * may read or write the state of this contract.
+ *
+ * CONST actions run the cache read only, every write of the call and of the
+ * destructors after it is dropped.
+ */
+class StateCache {
+ public:
+  static constexpr size_t read_size = PLATON_STATE_READ_SIZE;
+
+  /**
+   * @brief The cache of the running contract
+   *
+   * @return StateCache& The cache, it is never destroyed so that destructors
+   * run from __funcs_on_exit can still write to it
+   */
+  static StateCache &instance() {
+    static StateCache *cache = new StateCache();
+    return *cache;
+  }
+
+  /// Route state accesses through the cache, flushed at exit.
+  void enable() {
+    if (enabled_) return;
+    enabled_ = true;
+    ::atexit(flush_on_exit);
+  }
+
+  bool enabled() const { return enabled_; }
+
+  /// Drop every state write until the end of the call.
+  void set_read_only() { read_only_ = true; }
+
+  bool read_only() const { return read_only_; }
+
+  /**
+   * @brief Whether state writes are applied
+   *
+   * @return bool false in a read only call, the write is reported when
+   * PLATON_CONST_WRITE_CHECK is defined
+   */
+  bool writable() const {
+    if (!read_only_) return true;
+#ifdef PLATON_CONST_WRITE_CHECK
+    internal::platon_throw("state write in a const action\n");
+#endif
+    return false;
+  }
+
+  /**
+   * @brief Length of the value stored under @a key
+   *
+   * @param key Encoded key
+   * @return size_t The length, 0 when there is no value
+   */
+  size_t length(bytesConstRef key) {
+    if (!enabled_) return ::platon_get_state_length(key.data(), key.size());
+    return lookup(key).length;
+  }
+
+  /**
+   * @brief Read the value stored under @a key
+   *
+   * @param key Encoded key
+   * @param value Output buffer
+   * @param len Size of the output buffer
+   * @return int32_t The length of the value, when it is larger than @a len
+   * or -1 the value did not fit and needs a buffer of length()
+   */
+  int32_t read(bytesConstRef key, byte *value, size_t len) {
+    if (!enabled_) {
+      return ::platon_get_state(key.data(), key.size(), value, len);
+    }
+    Entry &entry = lookup(key);
+    if (!entry.loaded) {
+      entry.value.resize(entry.length);
+      if (::platon_get_state(key.data(), key.size(), entry.value.data(),
+                             entry.length) == -1) {
+        return -1;
+      }
+      entry.loaded = true;
+    }
+    ::memcpy(value, entry.value.data(),
+             len < entry.length ? len : entry.length);
+    return int32_t(entry.length);
+  }
+
+  /**
+   * @brief Store @a value under @a key, an empty value deletes the key
+   *
+   * @param key Encoded key
+   * @param value Encoded value
+   */
+  void write(bytesConstRef key, bytesConstRef value) {
+    if (!writable()) return;
+    if (!enabled_) {
+      host_write(key, value);
+      return;
+    }
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      it = entries_.emplace(key.toBytes(), Entry()).first;
+    }
+    Entry &entry = it->second;
+    entry.value.assign(value.begin(), value.end());
+    entry.length = value.size();
+    entry.loaded = true;
+    entry.dirty = true;
+  }
+
+  /// Write the changed values to the chain and forget every cached value.
+  void flush() {
+    for (auto &item : entries_) {
+      const Entry &entry = item.second;
+      if (entry.dirty) {
+        host_write(bytesConstRef(&item.first), bytesConstRef(&entry.value));
+      }
+    }
+    entries_.clear();
+  }
+
+ private:
+  struct Entry {
+    bytes value;
+    size_t length = 0;
+    bool loaded = false;
+    bool dirty = false;
+  };
+
+  struct KeyLess {
+    using is_transparent = void;
+
+    static bool less(bytesConstRef a, bytesConstRef b) {
+      size_t n = a.size() < b.size() ? a.size() : b.size();
+      int cmp = n == 0 ? 0 : ::memcmp(a.data(), b.data(), n);
+      return cmp < 0 || (cmp == 0 && a.size() < b.size());
+    }
+    bool operator()(const bytes &a, const bytes &b) const {
+      return less(bytesConstRef(&a), bytesConstRef(&b));
+    }
+    bool operator()(const bytes &a, bytesConstRef b) const {
+      return less(bytesConstRef(&a), b);
+    }
+    bool operator()(bytesConstRef a, const bytes &b) const {
+      return less(a, bytesConstRef(&b));
+    }
+  };
+
+  StateCache() = default;
+
+  static void flush_on_exit() { instance().flush(); }
+
+  static void host_write(bytesConstRef key, bytesConstRef value) {
+    byte del = 0;
+    ::platon_set_state(key.data(), key.size(),
+                       value.empty() ? &del : value.data(), value.size());
+  }
+
+  Entry &lookup(bytesConstRef key) {
+    auto it = entries_.find(key);
+    if (it != entries_.end()) return it->second;
+
+    // small values are read right away, the length is only asked for longer
+    Entry entry;
+    byte buffer[read_size];
+    int32_t ret = ::platon_get_state(key.data(), key.size(), buffer, read_size);
+    if (ret >= 0 && size_t(ret) <= read_size) {
+      entry.value.assign(buffer, buffer + ret);
+      entry.length = size_t(ret);
+      entry.loaded = true;
+    } else {
+      entry.length = ::platon_get_state_length(key.data(), key.size());
+      entry.loaded = entry.length == 0;
+    }
+    return entries_.emplace(key.toBytes(), std::move(entry)).first->second;
+  }
+
+  bool enabled_ = false;
+  bool read_only_ = false;
+  std::map<bytes, Entry, KeyLess> entries_;
+};
+
+}  // namespace platon
@@ -6,15 +6,69 @@
 #include <string>
 #include <vector>
 #include "RLP.h"
+#include "arena.hpp"
 #include "chain.hpp"
 #include "common.h"
 #include "print.hpp"
 #include "rlp_extend.hpp"
 #include "rlp_size.hpp"
+#include "rlp_view.hpp"
+#include "state_cache.hpp"
 
 const uint8_t value_prefix = 0xfe;
 
 namespace platon {
+
+namespace internal {
+/// Largest encoded size kept in a buffer on the stack.
+constexpr size_t max_stack_pack_size = 512;
+
+/// Bytes of stack needed to encode T after @a Prefix bytes, 0 when T is not
+/// bounded or too large for the stack.
+template <typename T, size_t Prefix = 0>
+constexpr size_t stack_pack_size() {
+  constexpr size_t bound = max_pack_size<T>();
+  if (bound == 0 || bound + Prefix > max_stack_pack_size) return 0;
+  return bound + Prefix;
+}
+
+/**
+ * @brief RLPStream for a value of type T and @a Prefix leading bytes
+ *
+ * The stream writes into a buffer on the stack when the encoded size of T is
+ * bounded at compile time, into a stream of the ScopedStream pool otherwise.
+ */
+template <typename T, size_t Prefix = 0,
+          size_t Bound = stack_pack_size<T, Prefix>()>
+class StateStream {
+ public:
+  StateStream() : stream_(buffer_, Bound) {}
+  RLPStream &stream() { return stream_; }
+
+ private:
+  byte buffer_[Bound];
+  RLPStream stream_;
+};
+
+template <typename T, size_t Prefix>
+class StateStream<T, Prefix, 0> {
+ public:
+  RLPStream &stream() { return *stream_; }
+
+ private:
+  ScopedStream stream_;
+};
+
+/// Store a value already encoded with its prefix under @a key.
+template <typename KEY>
+inline void write_state(const KEY &key, bytesConstRef value) {
+  if (!StateCache::instance().writable()) return;
+  StateStream<KEY> state_stream;
+  state_stream.stream().appendPlanned(key);
+  StateCache::instance().write(state_stream.stream().out(), value);
+}
+}  // namespace internal
+
 /**
  * @brief Set the State object
  *
@@ -25,21 +79,12 @@ namespace platon {
  */
 template <typename KEY, typename VALUE>
 inline void set_state(const KEY &key, const VALUE &value) {
-  RLPStream state_stream;
-  auto key_size = pack_size(key);
-  state_stream.reserve(key_size);
-
-  state_stream << key;
-  const bytesRef vect_key = state_stream.out();
-
-  RLPStream value_stream;
-  auto value_size = pack_size(value);
-  std::vector<byte> vect_value(sizeof(value_prefix), value_prefix);
-  value_stream.appendPrefix(vect_value);
-  value_stream.reserve(vect_value.size() + value_size);
-  value_stream << value;
-  ::platon_set_state(vect_key.data(), vect_key.size(),
-                     value_stream.out().data(), value_stream.out().size());
+  // nothing is encoded for a write that is dropped
+  if (!StateCache::instance().writable()) return;
+  internal::StateStream<VALUE, sizeof(value_prefix)> value_stream;
+  value_stream.stream().appendPrefix(value_prefix);
+  value_stream.stream().appendPlanned(value);
+  internal::write_state(key, value_stream.stream().out());
 }
 /**
  * @brief Get the State object
@@ -48,31 +93,64 @@ inline void set_state(const KEY &key, const VALUE &value) {
  * @tparam VALUE Value type
  * @param key Key
  * @param value Value
+ * @param raw If not null, receives the stored bytes as read
  * @return size_t Get the length of the data
  */
 template <typename KEY, typename VALUE>
-inline size_t get_state(const KEY &key, VALUE &value) {
-  RLPStream state_stream;
-  state_stream << key;
-  const bytesRef vect_key = state_stream.out();
-  size_t len = ::platon_get_state_length(vect_key.data(), vect_key.size());
-  if (len == 0) {
+inline size_t get_state(const KEY &key, VALUE &value, bytes *raw) {
+  internal::StateStream<KEY> state_stream;
+  state_stream.stream().appendPlanned(key);
+  const bytesRef vect_key = state_stream.stream().out();
+
+  // a value that fits the stack buffer comes back from a single host call,
+  // the length is only asked for longer ones
+  constexpr size_t bound =
+      internal::stack_pack_size<VALUE, sizeof(value_prefix)>();
+  constexpr size_t size =
+      bound > StateCache::read_size ? bound : StateCache::read_size;
+  byte buffer[size];
+  StateCache &cache = StateCache::instance();
+  int32_t ret = cache.read(vect_key, buffer, size);
+  if (ret == 0) {
     return 0;
   }
-  std::vector<byte> result;
-  result.resize(len);
-  int32_t ret = ::platon_get_state(vect_key.data(), vect_key.size(),
-                                   result.data(), result.size());
-  if (-1 == ret) {
-    return 0;
+  size_t len = size_t(ret);
+  byte *result = buffer;
+  ScopedArena scope;
+  if (ret < 0 || len > size) {
+    len = cache.length(vect_key);
+    if (len == 0) {
+      return 0;
+    }
+    result = static_cast<byte *>(scope.allocate(len));
+    if (-1 == cache.read(vect_key, result, len)) {
+      return 0;
+    }
+  }
+
+  if (raw != nullptr) raw->assign(result, result + len);
+
+  // views decoded from the state borrow it for the rest of the call
+  if (rlp_borrows_v<VALUE>) {
+    byte *copy = static_cast<byte *>(::malloc(len));
+    ::memcpy(copy, result, len);
+    result = copy;
   }
 
-  fetch(RLP(result.data() + sizeof(value_prefix),
-            result.size() - sizeof(value_prefix)),
+  // values written by set_state carry the prefix and need no encoding checks
+  RLP::Strictness strictness =
+      result[0] == value_prefix ? RLP::Trusted : RLP::VeryStrict;
+  fetch(RLP(result + sizeof(value_prefix), len - sizeof(value_prefix),
+            strictness),
         value);
   return len;
 }
 
+template <typename KEY, typename VALUE>
+inline size_t get_state(const KEY &key, VALUE &value) {
+  return get_state(key, value, nullptr);
+}
+
 /**
  * @brief delete State Object
  *
@@ -81,11 +159,11 @@ inline size_t get_state(const KEY &key, VALUE &value) {
  */
 template <typename KEY>
 inline void del_state(const KEY &key) {
-  RLPStream state_stream;
-  state_stream << key;
-  const bytesRef vect_key = state_stream.out();
-  byte del = 0;
-  ::platon_set_state(vect_key.data(), vect_key.size(), (const byte *)&del, 0);
+  if (!StateCache::instance().writable()) return;
+  internal::StateStream<KEY> state_stream;
+  state_stream.stream().appendPlanned(key);
+  const bytesRef vect_key = state_stream.stream().out();
+  StateCache::instance().write(vect_key, bytesConstRef());
 }
 
 /**
@@ -97,10 +175,10 @@ inline void del_state(const KEY &key) {
  */
 template <typename KEY>
 inline bool has_state(const KEY &key) {
-  RLPStream state_stream;
-  state_stream << key;
-  const bytesRef vect_key = state_stream.out();
-  size_t len = ::platon_get_state_length(vect_key.data(), vect_key.size());
+  internal::StateStream<KEY> state_stream;
+  state_stream.stream().appendPlanned(key);
+  const bytesRef vect_key = state_stream.stream().out();
+  size_t len = StateCache::instance().length(vect_key);
   return len != 0;
 }
 
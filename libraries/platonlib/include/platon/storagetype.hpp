@@ -20,6 +20,16 @@ namespace platon {
 /**
  * @brief Basic type package
  *
+ * The value is read from the blockchain when it is first used, so a member
+ * that an action never touches costs no state access. It is written back when
+ * the object is destroyed, and only if it was changed. Assignments and the
+ * mutating operators mark the value modified.
+ * After a mutable reference was handed out (operator*, operator->,
+ * operator[], self()) the value is encoded once when the object is
+ * destroyed, and written back only when the encoding differs from the bytes
+ * read from the blockchain. Read through get() or a const object to skip
+ * that encoding.
+ *
  * @tparam *Name Element value name, in the same contract, the name needs to be
  * unique
  * @tparam T Element type
@@ -31,130 +41,177 @@ class StorageType {
    * @brief Construct a new Storage Type object
    *
    */
-  StorageType() { Init(); }
+  StorageType() {}
 
   /**
    * @brief Construct a new Storage Type object
    *
    * @param d Element
    */
-  StorageType(const T &d) : default_(d) { Init(); }
+  StorageType(const T &d) : default_(d) {}
 
   StorageType(const StorageType<StorageName, T> &) = delete;
   StorageType(const StorageType<StorageName, T> &&) = delete;
   /**
-   * @brief Destroy the Storage Type object. Refresh to blockchain
+   * @brief Destroy the Storage Type object. Refresh to blockchain if the value
+   * changed
    *
    */
   ~StorageType() { Flush(); }
 
-  T &operator=(const T &t) { t_ = t; }
+  T &operator=(const T &t) {
+    access_ = Modified;
+    return t_ = t;
+  }
 
   template <typename P>
   bool operator==(const P &t) const {
-    return t_ == t;
+    return Value() == t;
   }
   template <typename P>
   bool operator!=(const P &t) const {
-    return t_ == t;
+    return Value() != t;
   }
   template <typename P>
   bool operator<(const P &t) const {
-    return t_ < t;
+    return Value() < t;
   }
   template <typename P>
   bool operator>=(const P &t) const {
-    return t_ >= t;
+    return Value() >= t;
   }
   template <typename P>
   bool operator<=(const P &t) const {
-    return t_ <= t;
+    return Value() <= t;
   }
   template <typename P>
   bool operator>(const P &t) const {
-    return t_ > t;
+    return Value() > t;
   }
 
   template <typename P>
-  T &operator^=(const P &t) const {
-    t_ ^= t;
-    return t_;
+  T &operator^=(const P &t) {
+    return Modify() ^= t;
   }
   template <typename P>
   T operator^(const P &t) const {
-    return t_ ^ t;
+    return Value() ^ t;
   }
   template <typename P>
-  T &operator|=(const P &t) const {
-    t_ |= t;
-    return t_;
+  T &operator|=(const P &t) {
+    return Modify() |= t;
   }
   template <typename P>
   T operator|(const P &t) const {
-    return t_ | t;
+    return Value() | t;
   }
   template <typename P>
-  T &operator&=(const P &t) const {
-    t_ &= t;
-    return t_;
+  T &operator&=(const P &t) {
+    return Modify() &= t;
   }
   template <typename P>
   T operator&(const P &t) const {
-    return t_ & t;
+    return Value() & t;
   }
 
-  T operator~() const { return ~t_; }
+  T operator~() const { return ~Value(); }
 
   T &operator<<(int offset) {
-    t_ << offset;
+    Expose() << offset;
     return t_;
   }
   T &operator>>(int offset) {
-    t_ >> offset;
+    Expose() >> offset;
     return t_;
   }
 
-  T &operator++() { return ++t_; }
-  T operator++(int) { return ++t_; }
+  T &operator++() { return ++Modify(); }
+  T operator++(int) { return ++Modify(); }
 
-  T &operator[](int i) { return t_[i]; }
+  T &operator[](int i) { return Expose()[i]; }
   template <typename P>
   T &operator+=(const P &p) {
-    t_ += p;
-    return t_;
+    return Modify() += p;
   }
   template <typename P>
   T &operator-=(const P &p) {
-    t_ -= p;
-    return t_;
+    return Modify() -= p;
   }
-  T &operator*() { return t_; }
-  T *operator->() { return &t_; }
+  T &operator*() { return Expose(); }
+  const T &operator*() const { return Value(); }
+  T *operator->() { return &Expose(); }
+  const T *operator->() const { return &Value(); }
 
-  operator bool() const { return t_ ? true : false; }
+  operator bool() const { return Value() ? true : false; }
 
-  T get() const { return t_; }
-  T &self() { return t_; }
-  const T &self() const { return t_; }
+  T get() const { return Value(); }
+  T &self() { return Expose(); }
+  const T &self() const { return Value(); }
 
  private:
   /**
-   * @brief Load from blockchain
+   * @brief Load from blockchain on first use
    *
    */
-  void Init() {
-    if (get_state(name_, t_) == 0) {
-      t_ = default_;
+  const T &Value() const {
+    if (access_ == Unloaded) {
+      if (get_state(name_, t_, &loaded_) == 0) {
+        t_ = default_;
+      }
+      access_ = Clean;
     }
+    return t_;
   }
   /**
-   * @brief Refresh to blockchain
+   * @brief Refresh to blockchain, unchanged values are not written
    *
    */
-  void Flush() { set_state(name_, t_); }
+  void Flush() {
+    if (access_ == Unloaded || access_ == Clean) return;
+    if (access_ == Exposed && StateCache::instance().read_only()) return;
+    if (access_ == Exposed) {
+      internal::StateStream<T, sizeof(value_prefix)> value_stream;
+      RLPStream &stream = value_stream.stream();
+      stream.appendPrefix(value_prefix);
+      stream.appendPlanned(t_);
+      if (stream.out().contentsEqual(loaded_)) return;
+      internal::write_state(name_, stream.out());
+      return;
+    }
+    set_state(name_, t_);
+  }
+
+  /// The value is about to be changed.
+  T &Modify() {
+    Value();
+    access_ = Modified;
+    return t_;
+  }
+
+  /// The value may be changed through the returned reference.
+  T &Expose() {
+    Value();
+    if (access_ == Clean) {
+      // a default value that is not stored yet is written only if changed
+      if (loaded_.empty()) {
+        internal::StateStream<T, sizeof(value_prefix)> value_stream;
+        value_stream.stream().appendPrefix(value_prefix);
+        value_stream.stream().appendPlanned(t_);
+        loaded_ = value_stream.stream().out().toBytes();
+      }
+      access_ = Exposed;
+    }
+    return t_;
+  }
+
+  enum Access : uint8_t { Unloaded, Clean, Exposed, Modified };
+
   T default_ = T();
   const uint64_t name_ = uint64_t(StorageName);
-  T t_;
+  mutable T t_;
+  mutable Access access_ = Unloaded;
+  // the stored bytes, compared with the value of an exposed reference
+  mutable bytes loaded_;
 };
 
 template <Name::Raw name>
@@ -205,6 +262,7 @@ using Array = class StorageType<name, std::array<T, N>>;
 template <Name::Raw name, typename... Types>
 using Tuple = class StorageType<name, std::tuple<Types...>>;
 
+// Deque, Queue and Stack: see db::Deque, which stores one key per element
 // template <Name::Raw name, typename T>
 // using Deque = class StorageType<name, std::deque<T>>;
 
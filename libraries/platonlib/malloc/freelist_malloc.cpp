@@ -0,0 +1,308 @@
+#include "platon/panic.hpp"
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern unsigned char __heap_base;
+
+#ifdef __cplusplus
+}
+#endif
+
+namespace platon {
+
+/**
+ * @brief Single threaded allocator for wasm32 with reclaiming free().
+ *
+ * Every block carries an 8 byte header: the size of the previous block (only
+ * valid when that block is free) followed by its own size and flags. Small
+ * blocks are kept in exact-size segregated free lists and are never merged.
+ * Large blocks are kept in power-of-two bins and are coalesced with their free
+ * neighbours, a free block next to the top of the heap is given back to the
+ * top. Linear memory is only grown when neither the bins nor the top can
+ * satisfy a request.
+ */
+struct fsmalloc {
+  static constexpr uint32_t wasm_page_size = 64 * 1024;
+
+  // block header layout
+  static constexpr size_t header_size = 2 * sizeof(uint32_t);
+  static constexpr size_t align_size = 8;
+  static constexpr size_t min_block_size = 16;
+
+  // flags in the low bits of the size field
+  static constexpr uint32_t prev_inuse = 1;
+  static constexpr uint32_t curr_inuse = 2;
+  static constexpr uint32_t flag_mask = 7;
+
+  // exact-size bins for blocks up to small_max_size bytes
+  static constexpr size_t small_max_size = 512;
+  static constexpr size_t small_bin_count = (small_max_size >> 3) + 1;
+
+  // power-of-two bins for larger blocks, the last bin is unbounded
+  static constexpr size_t large_min_shift = 9;
+  static constexpr size_t large_bin_count = 22;
+
+  struct block {
+    uint32_t prev_size;
+    uint32_t head;
+  };
+
+  struct free_block {
+    uint32_t prev_size;
+    uint32_t head;
+    free_block *next;
+    free_block *prev;
+  };
+
+  static size_t align(size_t size) {
+    return (size + align_size - 1) & ~(align_size - 1);
+  }
+
+  static size_t request_size(size_t sz) {
+    size_t real_size = align(sz + header_size);
+    return real_size < min_block_size ? min_block_size : real_size;
+  }
+
+  static size_t block_size(const block *b) { return b->head & ~flag_mask; }
+  static bool is_inuse(const block *b) { return b->head & curr_inuse; }
+  static bool is_prev_inuse(const block *b) { return b->head & prev_inuse; }
+  static block *to_block(void *ptr) {
+    return reinterpret_cast<block *>(static_cast<char *>(ptr) - header_size);
+  }
+  static char *to_mem(block *b) {
+    return reinterpret_cast<char *>(b) + header_size;
+  }
+  static block *next_block(block *b) {
+    return reinterpret_cast<block *>(reinterpret_cast<char *>(b) +
+                                     block_size(b));
+  }
+
+  static size_t large_index(size_t size) {
+    size_t index = 0;
+    for (size >>= large_min_shift; size > 1 && index + 1 < large_bin_count;
+         size >>= 1) {
+      ++index;
+    }
+    return index;
+  }
+
+  void init() {
+    volatile uintptr_t heap_base = uintptr_t(&__heap_base);
+    top = reinterpret_cast<char *>(align(heap_base));
+    end = reinterpret_cast<char *>(
+        uintptr_t(__builtin_wasm_memory_size(0)) * wasm_page_size);
+  }
+
+  /// Make sure at least @a size bytes are available after top.
+  void grow(size_t size) {
+    if (size_t(end - top) >= size) {
+      return;
+    }
+    size_t missing = size - size_t(end - top);
+    size_t pages = (missing + wasm_page_size - 1) / wasm_page_size;
+    size_t alloc_result = __builtin_wasm_memory_grow(0, pages);
+    if (size_t(-1) == alloc_result) {
+      internal::platon_throw("failed to allocate pages");
+    }
+    end += pages * wasm_page_size;
+  }
+
+  void push_small(block *b) {
+    size_t index = block_size(b) >> 3;
+    free_block *f = reinterpret_cast<free_block *>(b);
+    f->next = small_bins[index];
+    small_bins[index] = f;
+  }
+
+  void push_large(free_block *f) {
+    size_t index = large_index(f->head & ~flag_mask);
+    f->prev = nullptr;
+    f->next = large_bins[index];
+    if (f->next != nullptr) {
+      f->next->prev = f;
+    }
+    large_bins[index] = f;
+  }
+
+  void unlink_large(free_block *f) {
+    if (f->prev != nullptr) {
+      f->prev->next = f->next;
+    } else {
+      large_bins[large_index(f->head & ~flag_mask)] = f->next;
+    }
+    if (f->next != nullptr) {
+      f->next->prev = f->prev;
+    }
+  }
+
+  /// Mark a block of @a size bytes at @a b as used and hand back the tail.
+  char *take(block *b, size_t size) {
+    size_t total = block_size(b);
+    size_t rest = total - size;
+    if (rest < min_block_size) {
+      b->head |= curr_inuse;
+      next_block(b)->head |= prev_inuse;
+      return to_mem(b);
+    }
+
+    b->head = uint32_t(size) | curr_inuse | (b->head & prev_inuse);
+    block *tail = next_block(b);
+    if (rest <= small_max_size) {
+      tail->head = uint32_t(rest) | curr_inuse | prev_inuse;
+      next_block(tail)->head |= prev_inuse;
+      push_small(tail);
+    } else {
+      tail->head = uint32_t(rest) | prev_inuse;
+      next_block(tail)->prev_size = uint32_t(rest);
+      push_large(reinterpret_cast<free_block *>(tail));
+    }
+    return to_mem(b);
+  }
+
+  char *from_large_bins(size_t size) {
+    for (size_t index = large_index(size); index < large_bin_count; ++index) {
+      for (free_block *f = large_bins[index]; f != nullptr; f = f->next) {
+        if ((f->head & ~flag_mask) >= size) {
+          unlink_large(f);
+          return take(reinterpret_cast<block *>(f), size);
+        }
+      }
+    }
+    return nullptr;
+  }
+
+  char *from_top(size_t size) {
+    grow(size);
+    block *b = reinterpret_cast<block *>(top);
+    b->head = uint32_t(size) | curr_inuse | prev_inuse;
+    top += size;
+    return to_mem(b);
+  }
+
+  char *operator()(size_t sz) {
+    if (sz == 0) return nullptr;
+    if (top == nullptr) init();
+    if (sz > (size_t(1) << 31)) {
+      internal::platon_throw("failed to allocate pages");
+    }
+
+    size_t size = request_size(sz);
+    if (size <= small_max_size) {
+      size_t index = size >> 3;
+      free_block *f = small_bins[index];
+      if (f != nullptr) {
+        small_bins[index] = f->next;
+        return to_mem(reinterpret_cast<block *>(f));
+      }
+    }
+
+    char *ret = from_large_bins(size);
+    if (ret != nullptr) return ret;
+    return from_top(size);
+  }
+
+  void release(void *ptr) {
+    block *b = to_block(ptr);
+    size_t size = block_size(b);
+    if (size <= small_max_size) {
+      push_small(b);
+      return;
+    }
+
+    block *next = next_block(b);
+    if (!is_prev_inuse(b)) {
+      block *prev = reinterpret_cast<block *>(reinterpret_cast<char *>(b) -
+                                              b->prev_size);
+      unlink_large(reinterpret_cast<free_block *>(prev));
+      size += block_size(prev);
+      b = prev;
+    }
+
+    if (reinterpret_cast<char *>(next) == top) {
+      top = reinterpret_cast<char *>(b);
+      return;
+    }
+
+    if (!is_inuse(next)) {
+      unlink_large(reinterpret_cast<free_block *>(next));
+      size += block_size(next);
+      next = next_block(next);
+    }
+
+    b->head = uint32_t(size) | prev_inuse;
+    next->prev_size = uint32_t(size);
+    next->head &= ~prev_inuse;
+    push_large(reinterpret_cast<free_block *>(b));
+  }
+
+  char *resize(void *ptr, size_t sz) {
+    block *b = to_block(ptr);
+    size_t old_size = block_size(b);
+    size_t size = request_size(sz);
+    if (size <= old_size) return static_cast<char *>(ptr);
+
+    // grow a large block in place into the top or a free neighbour
+    if (old_size > small_max_size) {
+      block *next = next_block(b);
+      if (reinterpret_cast<char *>(next) == top) {
+        grow(size - old_size);
+        b->head = uint32_t(size) | (b->head & flag_mask);
+        top = reinterpret_cast<char *>(b) + size;
+        return static_cast<char *>(ptr);
+      }
+      if (!is_inuse(next) && old_size + block_size(next) >= size) {
+        unlink_large(reinterpret_cast<free_block *>(next));
+        b->head = uint32_t(old_size + block_size(next)) | (b->head & flag_mask);
+        return take(b, size);
+      }
+    }
+
+    char *new_alloc = (*this)(sz);
+    memcpy(new_alloc, ptr, old_size - header_size);
+    release(ptr);
+    return new_alloc;
+  }
+
+  char *top;
+  char *end;
+  free_block *small_bins[small_bin_count];
+  free_block *large_bins[large_bin_count];
+};
+fsmalloc _fsmalloc;
+}  // namespace platon
+
+extern "C" {
+
+void *malloc(size_t size) {
+  void *ret = platon::_fsmalloc(size);
+  return ret;
+}
+
+void *memset(void *, int, size_t);
+void *calloc(size_t count, size_t size) {
+  if (size != 0 && count > size_t(-1) / size) return nullptr;
+  if (void *ptr = platon::_fsmalloc(count * size)) {
+    memset(ptr, 0, count * size);
+    return ptr;
+  }
+  return nullptr;
+}
+
+void *realloc(void *ptr, size_t size) {
+  if (nullptr == ptr) return platon::_fsmalloc(size);
+  if (size == 0) {
+    platon::_fsmalloc.release(ptr);
+    return nullptr;
+  }
+  return platon::_fsmalloc.resize(ptr, size);
+}
+
+void free(void *ptr) {
+  if (nullptr == ptr) return;
+  platon::_fsmalloc.release(ptr);
+}
+}
@@ -54,7 +54,7 @@ struct dsmalloc {
     // allocate memeory
     if(pages_to_alloc > 0){
       size_t alloc_result = __builtin_wasm_memory_grow(0, pages_to_alloc);
-      if (0 == alloc_result) {
+      if (size_t(-1) == alloc_result) {
         internal::platon_throw("failed to allocate pages");
       }
     }
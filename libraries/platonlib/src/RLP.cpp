@@ -7,7 +7,9 @@ namespace platon {
 // bytes RLPNull = rlp("");
 // bytes RLPEmptyList = rlpList();
 
-RLP::RLP(bytesConstRef _d, Strictness _s) : m_data(_d) {
+RLP::RLP(bytesConstRef _d, Strictness _s)
+    : m_data(_d), m_trusted(_s & Trusted) {
+  if (m_trusted) return;
   if ((_s & FailIfTooBig) && actualSize() < _d.size()) {
     if (_s & ThrowOnFail)
       internal::platon_throw("over size rlp");
@@ -25,17 +27,19 @@ RLP::RLP(bytesConstRef _d, Strictness _s) : m_data(_d) {
 RLP::iterator& RLP::iterator::operator++() {
   if (m_remaining) {
     m_currentItem.retarget(m_currentItem.next().data(), m_remaining);
-    m_currentItem = m_currentItem.cropped(0, sizeAsEncoded(m_currentItem));
+    m_currentItem =
+        m_currentItem.cropped(0, sizeAsEncoded(m_currentItem, m_trusted));
     m_remaining -= std::min<size_t>(m_remaining, m_currentItem.size());
   } else
     m_currentItem.retarget(m_currentItem.next().data(), 0);
   return *this;
 }
 
-RLP::iterator::iterator(RLP const& _parent, bool _begin) {
+RLP::iterator::iterator(RLP const& _parent, bool _begin)
+    : m_trusted(_parent.m_trusted) {
   if (_begin && _parent.isList()) {
     auto pl = _parent.payload();
-    m_currentItem = pl.cropped(0, sizeAsEncoded(pl));
+    m_currentItem = pl.cropped(0, sizeAsEncoded(pl, m_trusted));
     m_remaining = pl.size() - m_currentItem.size();
   } else {
     m_currentItem = _parent.data().cropped(_parent.data().size());
@@ -45,16 +49,16 @@ RLP::iterator::iterator(RLP const& _parent, bool _begin) {
 
 RLP RLP::operator[](size_t _i) const {
   if (_i < m_lastIndex) {
-    m_lastEnd = sizeAsEncoded(payload());
+    m_lastEnd = sizeAsEncoded(payload(), m_trusted);
     m_lastItem = payload().cropped(0, m_lastEnd);
     m_lastIndex = 0;
   }
   for (; m_lastIndex < _i && m_lastItem.size(); ++m_lastIndex) {
     m_lastItem = payload().cropped(m_lastEnd);
-    m_lastItem = m_lastItem.cropped(0, sizeAsEncoded(m_lastItem));
+    m_lastItem = m_lastItem.cropped(0, sizeAsEncoded(m_lastItem, m_trusted));
     m_lastEnd += m_lastItem.size();
   }
-  return RLP(m_lastItem, int(ThrowOnFail) | int(FailIfTooSmall));
+  return RLP(m_lastItem, itemStrictness(m_trusted));
 }
 
 size_t RLP::actualSize() const {
@@ -64,7 +68,7 @@ size_t RLP::actualSize() const {
   return 0;
 }
 
-void RLP::requireGood() const {
+void RLP::checkGood() const {
   if (isNull()) internal::platon_throw("bad rlp");
   byte n = m_data[0];
   if (n != c_rlpDataImmLenStart + 1) return;
@@ -74,6 +78,7 @@ void RLP::requireGood() const {
 
 bool RLP::isInt() const {
   if (isNull()) return false;
+  if (m_trusted) return isData();
   requireGood();
   byte n = m_data[0];
   if (n < c_rlpDataImmLenStart)
@@ -92,8 +97,30 @@ bool RLP::isInt() const {
   return false;
 }
 
+size_t RLP::trustedLength() const {
+  byte const n = m_data[0];
+  unsigned lengthSize = 0;
+  if (n < c_rlpDataImmLenStart)
+    return 1;
+  else if (n <= c_rlpDataIndLenZero)
+    return n - c_rlpDataImmLenStart;
+  else if (n < c_rlpListStart)
+    lengthSize = n - c_rlpDataIndLenZero;
+  else if (n <= c_rlpListIndLenZero)
+    return n - c_rlpListStart;
+  else
+    lengthSize = n - c_rlpListIndLenZero;
+
+  // the length bytes must still be inside the data
+  if (m_data.size() <= lengthSize) internal::platon_throw("bad rlp");
+  size_t ret = 0;
+  for (unsigned i = 0; i < lengthSize; ++i) ret = (ret << 8) | m_data[i + 1];
+  return ret;
+}
+
 size_t RLP::length() const {
   if (isNull()) return 0;
+  if (m_trusted) return trustedLength();
   requireGood();
   size_t ret = 0;
   byte const n = m_data[0];
@@ -142,12 +169,26 @@ size_t RLP::items() const {
   if (isList()) {
     bytesConstRef d = payload();
     size_t i = 0;
-    for (; d.size(); ++i) d = d.cropped(sizeAsEncoded(d));
+    for (; d.size(); ++i) d = d.cropped(sizeAsEncoded(d, m_trusted));
     return i;
   }
   return 0;
 }
 
+// RLPIndex
+void RLPIndex::build() {
+  if (!m_list.isList()) return;
+  m_payload = m_list.payload();
+
+  size_t offset = 0;
+  for (; offset < m_payload.size(); ++m_count) {
+    pushOffset(offset);
+    offset +=
+        RLP::sizeAsEncoded(m_payload.cropped(offset), m_list.m_trusted);
+  }
+  pushOffset(offset);
+}
+
 // RLPStream
 RLPStream& RLPStream::appendRaw(bytesConstRef _s, size_t _itemCount) {
   m_out.append(_s.begin(), _s.end());
@@ -165,21 +206,85 @@ void RLPStream::noteAppended(size_t _itemCount) {
       break;
     else {
       auto p = m_listStack.back().second;
+      auto planned = m_listStack.back().planned;
       m_listStack.pop_back();
-      size_t s = m_out.size() - p;  // list size
+      if (planned != c_noListPlan) {
+        // the header is already in place unless the plan was wrong
+        if (m_out.size() - p != planned) fixListHeader(p, planned);
+      } else {
+        size_t s = m_out.size() - p;  // list size
 
-      size_t appned_length = rlp_list_size(s);
-      m_out.resize(p + appned_length);
-      byte* data = m_out.data() + p;
-      platon_rlp_list(data, s, data);
+        // short lists only need their payload moved by one byte
+        if (s < c_rlpListImmLenCount) {
+          m_out.resize(p + 1 + s);
+          byte* data = m_out.data() + p;
+          memmove(data + 1, data, s);
+          *data = byte(c_rlpListStart + s);
+        } else {
+          size_t appned_length = rlp_list_size(s);
+          m_out.resize(p + appned_length);
+          byte* data = m_out.data() + p;
+          platon_rlp_list(data, s, data);
+        }
+      }
     }
     _itemCount = 1;  // for all following iterations, we've effectively appended
                      // a single item only since we completed a list.
   }
 }
 
+static size_t listHeaderSize(size_t _size) {
+  return _size < c_rlpListImmLenCount ? 1 : 1 + bytesRequired(_size);
+}
+
+static void writeListHeader(byte* _dest, size_t _size) {
+  if (_size < c_rlpListImmLenCount) {
+    *_dest = byte(c_rlpListStart + _size);
+    return;
+  }
+  unsigned br = bytesRequired(_size);
+  *_dest = byte(c_rlpListIndLenZero + br);
+  for (byte* b = _dest + br; _size; _size >>= 8) *(b--) = byte(_size);
+}
+
+void RLPStream::pushListHeader(size_t _size) {
+  size_t old_size = m_out.size();
+  m_out.resize(old_size + listHeaderSize(_size));
+  writeListHeader(m_out.data() + old_size, _size);
+}
+
+void RLPStream::fixListHeader(size_t _start, size_t _planned) {
+  size_t s = m_out.size() - _start;
+  size_t planned_header = listHeaderSize(_planned);
+  size_t header = listHeaderSize(s);
+  size_t begin = _start - planned_header;
+  if (header > planned_header) {
+    m_out.resize(m_out.size() + header - planned_header);
+  }
+  if (header != planned_header) {
+    memmove(m_out.data() + begin + header, m_out.data() + _start, s);
+    m_out.relocate(begin + header + s);
+  }
+  writeListHeader(m_out.data() + begin, s);
+  m_listPlanIndex = m_listPlan.size() / sizeof(size_t);
+}
+
 RLPStream& RLPStream::appendList(size_t _items) {
   //	cdebug << "appendList(" << _items << ")";
+  if (hasListPlan()) {
+    size_t planned =
+        reinterpret_cast<const size_t*>(m_listPlan.data())[m_listPlanIndex++];
+    if (_items) {
+      pushListHeader(planned);
+      m_listStack.push_back(std::make_pair(_items, m_out.size()), planned);
+      return *this;
+    }
+    if (planned != 0) m_listPlanIndex = m_listPlan.size() / sizeof(size_t);
+    m_out.push_back(c_rlpListStart);
+    noteAppended();
+    return *this;
+  }
+
   if (_items)
     m_listStack.push_back(std::make_pair(_items, m_out.size()));
   else
@@ -201,6 +306,22 @@ RLPStream& RLPStream::appendList(bytesConstRef _rlp) {
 RLPStream& RLPStream::append(bytesConstRef _s) {
   size_t length = _s.size();
   byte const* data = _s.data();
+
+  // short strings are cheaper to encode here than through the host
+  if (length < c_rlpDataImmLenCount) {
+    if (length == 1 && *data < c_rlpDataImmLenStart) {
+      m_out.push_back(*data);
+    } else {
+      size_t old_size = m_out.size();
+      m_out.resize(old_size + 1 + length);
+      byte* dest = m_out.data() + old_size;
+      *dest = byte(c_rlpDataImmLenStart + length);
+      memcpy(dest + 1, data, length);
+    }
+    noteAppended();
+    return *this;
+  }
+
   size_t appned_length = rlp_bytes_size(data, length);
   size_t old_size = m_out.size();
   m_out.resize(old_size + appned_length);
@@ -212,6 +333,9 @@ RLPStream& RLPStream::append(bytesConstRef _s) {
 RLPStream& RLPStream::append(bigint _i) {
   uint64_t low = _i;
   uint64_t heigh = _i >> 64;
+  if (heigh == 0) {
+    return appendUnsigned(low);
+  }
   size_t appned_length = rlp_u128_size(heigh, low);
   size_t old_size = m_out.size();
   m_out.resize(old_size + appned_length);
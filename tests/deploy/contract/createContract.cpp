@@ -6,9 +6,9 @@ using namespace platon;
 
 CONTRACT UpdateContract : public platon::Contract {
     public:
-        CONST void init(){}
+        CONST void init() const {}
 
-        CONST int32_t get_contract_length(const Address & contract_address){
+        CONST int32_t get_contract_length(const Address & contract_address) const {
             size_t code_length = platon_contract_code_length(contract_address.data());
             if(0 == code_length) return 0;
             bytes contract_code(code_length);
@@ -26,7 +26,7 @@ CONTRACT UpdateContract : public platon::Contract {
             if(info.second) set_state("deploy", info.first);
         }
 
-        CONST Address get_deploy_address(){
+        CONST Address get_deploy_address() const {
             Address result;
             get_state("deploy", result);
             return result;
@@ -37,7 +37,7 @@ CONTRACT UpdateContract : public platon::Contract {
             if(info.second) set_state("clone", info.first);
         }
 
-        CONST Address get_clone_address(){
+        CONST Address get_clone_address() const {
             Address result;
             get_state("clone", result);
             return result;
@@ -47,7 +47,7 @@ CONTRACT UpdateContract : public platon::Contract {
             set_state("simple", addr);
         }
 
-        CONST Address get_simple_address(){
+        CONST Address get_simple_address() const {
             Address result;
             get_state("simple", result);
             return result;
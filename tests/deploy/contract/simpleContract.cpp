@@ -12,7 +12,7 @@ CONTRACT SimpleStorage: public platon::Contract
 			storedData.self() = input;		
 		}
 		
-		CONST uint64_t get()
+		CONST uint64_t get() const
 		{
 			return storedData.self();
 		}
@@ -22,7 +22,7 @@ CONTRACT SimpleStorage: public platon::Contract
 			migrateAddress.self() = addr;		
 		}
 		
-		CONST Address get_address()
+		CONST Address get_address() const
 		{
 			return migrateAddress.self();
 		}
@@ -0,0 +1,47 @@
+#undef NDEBUG
+#define TESTNET
+#include "platon/platon.hpp"
+#include "../../unit/unit_test.hpp"
+
+// The old data encodes every field the way RLPStream did before: widen it to
+// u128 and let the host compute the size and the bytes.
+#ifdef OLD
+void append_field(RLPStream &stream, bigint value) {
+  uint64_t low = value;
+  uint64_t heigh = value >> 64;
+  byte buffer[17];
+  size_t size = ::rlp_u128_size(heigh, low);
+  ::platon_rlp_u128(heigh, low, buffer);
+  stream.appendRaw(bytesConstRef(buffer, size));
+}
+#else
+template <typename T>
+void append_field(RLPStream &stream, T value) {
+  stream << value;
+}
+#endif
+
+TEST_CASE(debug, int_fields) {
+  uint8_t one = 0xff;
+  uint16_t two = 0xffff;
+  uint32_t four = 0xffffffff;
+  uint64_t eight = 0xffffffffffffffffllu;
+  int64_t begin_time = platon_nano_time();
+  for (int i = 0; i < 100000; i++) {
+    RLPStream wht_stream;
+    wht_stream.reserve(64);
+    wht_stream.appendList(16);
+    for (int j = 0; j < 4; j++) {
+      append_field(wht_stream, one);
+      append_field(wht_stream, two);
+      append_field(wht_stream, four);
+      append_field(wht_stream, eight);
+    }
+    bytesRef result = wht_stream.out();
+  }
+  int64_t end_time = platon_nano_time();
+  printf("rlp encoding times:%d\t\n", 100000 * 16);
+  printf("spent time:%lld\t\n", (end_time - begin_time) / 1000000000);
+}
+
+UNITTEST_MAIN() { RUN_TEST(debug, int_fields); }
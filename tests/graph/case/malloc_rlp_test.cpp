@@ -0,0 +1,38 @@
+#undef NDEBUG
+#define TESTNET
+#include "platon/platon.hpp"
+#include "../../unit/unit_test.hpp"
+
+// Build with platon-cpp --allocator=bump|freelist|arena to compare the page
+// growth and gas of the allocators on the same workload.
+
+std::string one_case(int number) {
+  std::string one;
+  for (int i = 0; i < number; i++) {
+    one += 'a';
+  }
+  return one;
+}
+
+TEST_CASE(malloc, rlp) {
+  std::string test_string = one_case(100);
+  bigint test_int = 0xffffffffffffffffllu;
+  size_t begin_pages = __builtin_wasm_memory_size(0);
+  int64_t begin_time = platon_nano_time();
+  for (int i = 0; i < 10000; i++) {
+    std::vector<std::string> strings(10, test_string);
+    std::vector<bigint> ints(10, test_int);
+    RLPStream wht_stream;
+    wht_stream << strings << ints;
+    bytes result = wht_stream.out().toBytes();
+    std::vector<std::string> decode_strings;
+    fetch(RLP(result)[0], decode_strings);
+  }
+  int64_t end_time = platon_nano_time();
+  size_t end_pages = __builtin_wasm_memory_size(0);
+  printf("rlp encoding times:%d\t\n", 10000);
+  printf("memory pages:%lu\t\n", end_pages - begin_pages);
+  printf("spent time:%lld\t\n", (end_time - begin_time) / 1000000000);
+}
+
+UNITTEST_MAIN() { RUN_TEST(malloc, rlp); }
@@ -0,0 +1,43 @@
+#undef NDEBUG
+#define TESTNET
+#include "platon/platon.hpp"
+#include "../../unit/unit_test.hpp"
+
+class Member {
+ public:
+  std::string name;
+  uint64_t age;
+  std::vector<uint32_t> scores;
+  PLATON_SERIALIZE(Member, (name)(age)(scores))
+};
+
+class Group {
+ public:
+  std::string info;
+  std::map<std::string, Member> members;
+  PLATON_SERIALIZE(Group, (info)(members))
+};
+
+TEST_CASE(debug, nested_struct) {
+  Group group;
+  group.info = "group";
+  for (int i = 0; i < 10; i++) {
+    Member one;
+    one.name = std::string(i * 10, 'a');
+    one.age = i;
+    one.scores = std::vector<uint32_t>(i, 0xffff);
+    group.members[std::to_string(i)] = one;
+  }
+
+  int64_t begin_time = platon_nano_time();
+  for (int i = 0; i < 10000; i++) {
+    RLPStream wht_stream;
+    wht_stream << group;
+    bytesRef result = wht_stream.out();
+  }
+  int64_t end_time = platon_nano_time();
+  printf("rlp encoding times:%d\t\n", 10000);
+  printf("spent time:%lld\t\n", (end_time - begin_time) / 1000000000);
+}
+
+UNITTEST_MAIN() { RUN_TEST(debug, nested_struct); }
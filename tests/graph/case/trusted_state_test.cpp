@@ -0,0 +1,45 @@
+#undef NDEBUG
+#define TESTNET
+#include "platon/platon.hpp"
+#include "../../unit/unit_test.hpp"
+
+// The old data decodes state with every encoding check, the new data reads it
+// the way get_state reads values written by set_state.
+#ifdef OLD
+const RLP::Strictness strictness = RLP::VeryStrict;
+#else
+const RLP::Strictness strictness = RLP::Trusted;
+#endif
+
+class Member {
+ public:
+  std::string name;
+  uint64_t age;
+  std::vector<uint32_t> scores;
+  PLATON_SERIALIZE(Member, (name)(age)(scores))
+};
+
+TEST_CASE(debug, trusted_state) {
+  std::vector<Member> members;
+  for (int i = 0; i < 100; i++) {
+    Member one;
+    one.name = std::string(i % 60, 'a');
+    one.age = i * 1000;
+    one.scores = std::vector<uint32_t>(10, 0xffffff);
+    members.push_back(one);
+  }
+  RLPStream stream;
+  stream << members;
+  bytesConstRef data = stream.out();
+
+  int64_t begin_time = platon_nano_time();
+  for (int i = 0; i < 1000; i++) {
+    std::vector<Member> result;
+    fetch(RLP(data, strictness), result);
+  }
+  int64_t end_time = platon_nano_time();
+  printf("rlp encoding times:%d\t\n", 1000);
+  printf("spent time:%lld\t\n", (end_time - begin_time) / 1000000000);
+}
+
+UNITTEST_MAIN() { RUN_TEST(debug, trusted_state); }
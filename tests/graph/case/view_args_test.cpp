@@ -0,0 +1,34 @@
+#undef NDEBUG
+#define TESTNET
+#include "platon/platon.hpp"
+#include "../../unit/unit_test.hpp"
+
+// The old data copies every argument into an owning container, the new data
+// borrows the arguments from the input buffer.
+#ifdef OLD
+using Args = std::tuple<std::string, bytes, std::vector<bytes>>;
+#else
+using Args =
+    std::tuple<std::string_view, bytesConstRef, RLPView<bytesConstRef>>;
+#endif
+
+TEST_CASE(debug, view_args) {
+  std::vector<bytes> list(10, bytes(200, 0xcc));
+  RLPStream input;
+  input << std::make_tuple(std::string(100, 'a'), bytes(1000, 0xbb), list);
+  bytesConstRef data = input.out();
+
+  int64_t begin_time = platon_nano_time();
+  for (int i = 0; i < 10000; i++) {
+    Args args;
+    fetch(RLP(data), args);
+    size_t total = 0;
+    for (auto const &one : std::get<2>(args)) total += one.size();
+    ASSERT_EQ(total, 2000);
+  }
+  int64_t end_time = platon_nano_time();
+  printf("rlp encoding times:%d\t\n", 10000);
+  printf("spent time:%lld\t\n", (end_time - begin_time) / 1000000000);
+}
+
+UNITTEST_MAIN() { RUN_TEST(debug, view_args); }
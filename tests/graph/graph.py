@@ -70,6 +70,52 @@ def spent_time(case_name):
     plt.close()
 
 
+def run_case(command, values):
+    prco = os.popen(command)
+    output_info = str(prco.read())
+    lines = output_info.splitlines()
+    for line in lines:
+        print(line)
+        if(line.startswith('memory pages')):
+            all = line.split(':')
+            values['pages'] = int(all[-1])
+
+        if(line.startswith('gas cost')):
+            all = line.split(',')[0].split(':')
+            values['gas'] = int(all[-1])
+
+
+def memory_usage(case_name):
+    current_dir = os.path.dirname(os.path.abspath(__file__))
+    case_dir = os.path.join(current_dir, "case")
+    case_wasm_file = os.path.join(case_dir, case_name + "_test.wasm")
+    command = "platon-test exec  --file " + case_wasm_file
+
+    # 每种分配器分别编译运行一次
+    allocators = ['bump', 'freelist', 'arena']
+    colors = ['green', 'red', 'blue']
+    results = []
+    for allocator in allocators:
+        values = {'pages': 0, 'gas': 0}
+        os.chdir(case_dir)
+        os.system("platon-cpp --allocator=" + allocator + " " + case_name + "_test.cpp")
+        run_case(command, values)
+        results.append(values)
+
+    # 生成图表
+    os.chdir(current_dir)
+    fig, (pages_axis, gas_axis) = plt.subplots(1, 2)
+    pages_axis.bar(allocators, [one['pages'] for one in results], color=colors)
+    pages_axis.set_title('memory pages')
+    gas_axis.bar(allocators, [one['gas'] for one in results], color=colors)
+    gas_axis.set_title('gas cost')
+    fig.suptitle(case_name + ' allocator')
+
+    # 保存图表
+    plt.savefig(case_name + ".png")
+    plt.close()
+
+
 if __name__ == "__main__":
     try:
         spent_time("bigint_one")
@@ -86,6 +132,11 @@ if __name__ == "__main__":
         spent_time("list_string_one")
         spent_time("list_string_two")
         spent_time("list_string_three")
+        spent_time("int_fields")
+        spent_time("nested_struct")
+        spent_time("view_args")
+        spent_time("trusted_state")
+        memory_usage("malloc_rlp")
 
     except Exception as e:
         print('{} {}'.format('exception: ', e))
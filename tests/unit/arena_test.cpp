@@ -0,0 +1,112 @@
+#include "platon/arena.hpp"
+#include "platon/rlp_serialize.hpp"
+#include "platon/storage.hpp"
+#include "unit_test.hpp"
+
+using namespace platon;
+std::map<std::vector<byte>, std::vector<byte>> result;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void platon_set_state(const uint8_t *key, size_t klen, const uint8_t *value,
+                      size_t vlen) {
+  result[std::vector<byte>(key, key + klen)] =
+      std::vector<byte>(value, value + vlen);
+}
+
+size_t platon_get_state_length(const uint8_t *key, size_t klen) {
+  return result[std::vector<byte>(key, key + klen)].size();
+}
+
+int32_t platon_get_state(const uint8_t *key, size_t klen, uint8_t *value,
+                         size_t vlen) {
+  const std::vector<byte> &vect_value =
+      result[std::vector<byte>(key, key + klen)];
+  for (size_t i = 0; i < vlen && i < vect_value.size(); i++) {
+    *(value + i) = vect_value[i];
+  }
+  return vect_value.size();
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+TEST_CASE(arena, rewind) {
+  Arena arena;
+  auto begin = arena.mark();
+  void *first = arena.allocate(3);
+  void *second = arena.allocate(10);
+  ASSERT_EQ(size_t(first) % Arena::align_size, 0);
+  ASSERT_EQ(size_t(second) % Arena::align_size, 0);
+  ASSERT_EQ((uint8_t *)second - (uint8_t *)first, 8);
+
+  auto middle = arena.mark();
+  void *big = arena.allocate(Arena::default_block_size * 2);
+  ASSERT_NE(big, nullptr);
+  size_t capacity = arena.capacity();
+
+  arena.rewind(middle);
+  ASSERT_EQ(arena.allocate(Arena::default_block_size * 2), big);
+  arena.rewind(begin);
+  ASSERT_EQ(arena.allocate(3), first);
+  ASSERT_EQ(arena.capacity(), capacity);
+}
+
+TEST_CASE(arena, scoped) {
+  Arena arena;
+  void *outer = nullptr;
+  {
+    ScopedArena scope(arena);
+    outer = scope.allocate(16);
+    {
+      ScopedArena inner(arena);
+      ASSERT_NE(inner.allocate(16), outer);
+    }
+    ASSERT_EQ((uint8_t *)scope.allocate(16), (uint8_t *)outer + 16);
+  }
+  ASSERT_EQ(arena.allocate(16), outer);
+}
+
+TEST_CASE(arena, stream) {
+  std::vector<std::string> data = {"hello", "world", std::string(100, 'a')};
+  RLPStream heap_stream;
+  heap_stream << data;
+
+  ScopedArena scope;
+  RLPStream arena_stream(scope.arena());
+  arena_stream << data;
+  ASSERT_EQ(arena_stream.out().toBytes(), heap_stream.out().toBytes());
+
+  BytesBuffer buffer(scope.arena());
+  for (int i = 0; i < 1000; i++) buffer.push_back(uint8_t(i));
+  ASSERT_EQ(buffer.size(), 1000);
+  ASSERT_EQ(buffer[999], uint8_t(999));
+}
+
+TEST_CASE(arena, storage) {
+  std::string key = "arena";
+  std::vector<std::string> value = {"hello", std::string(200, 'b')};
+  set_state(key, value);
+  std::vector<std::string> stored;
+  get_state(key, stored);
+  ASSERT_EQ(stored, value);
+
+  size_t capacity = Arena::transient().capacity();
+  for (int i = 0; i < 1000; i++) {
+    std::vector<std::string> loop_value;
+    set_state(key, value);
+    get_state(key, loop_value);
+    ASSERT(has_state(key));
+  }
+  ASSERT_EQ(Arena::transient().capacity(), capacity);
+}
+
+UNITTEST_MAIN() {
+  RUN_TEST(arena, rewind);
+  RUN_TEST(arena, scoped);
+  RUN_TEST(arena, stream);
+  RUN_TEST(arena, storage);
+}
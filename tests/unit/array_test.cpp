@@ -7,6 +7,40 @@ typedef platon::db::Array<"int"_n, uint8_t, 20> ArrayInt;
 typedef platon::db::Array<"str"_n, std::string, 2> ArrayStr;
 typedef platon::db::Array<"set"_n, std::string, 10> ArraySet;
 typedef platon::db::Array<"test"_n, std::string, 3> ArrayName;
+typedef platon::db::Array<"read"_n, std::string, 4> ArrayRead;
+
+std::map<std::vector<uint8_t>, std::vector<uint8_t>> result;
+size_t set_count = 0;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void platon_set_state(const uint8_t *key, size_t klen, const uint8_t *value,
+                      size_t vlen) {
+  result[std::vector<uint8_t>(key, key + klen)] =
+      std::vector<uint8_t>(value, value + vlen);
+  set_count++;
+}
+
+size_t platon_get_state_length(const uint8_t *key, size_t klen) {
+  return result[std::vector<uint8_t>(key, key + klen)].size();
+}
+
+int32_t platon_get_state(const uint8_t *key, size_t klen, uint8_t *value,
+                         size_t vlen) {
+  const std::vector<uint8_t> &stored =
+      result[std::vector<uint8_t>(key, key + klen)];
+  if (stored.size() > vlen) {
+    return -1;
+  }
+  std::copy(stored.begin(), stored.end(), value);
+  return stored.size();
+}
+
+#ifdef __cplusplus
+}
+#endif
 
 TEST_CASE(array, batch) {
   {
@@ -132,9 +166,46 @@ TEST_CASE(array, name) {
   arrName[2] = "test2";
 }
 
+TEST_CASE(array, read_only) {
+  {
+    ArrayRead array;
+    array[0] = "hello";
+  }
+
+  // reads do not write anything back
+  set_count = 0;
+  {
+    ArrayRead array;
+    ASSERT(array[0] == "hello");
+    ASSERT(array.get(1).empty());
+    for (auto iter = array.cbegin(); iter != array.cend(); iter++) {
+      ASSERT((*iter).size() <= 5);
+    }
+  }
+  ASSERT_EQ(set_count, 0);
+
+  // an element that is not stored is created once handed out mutably
+  {
+    ArrayRead array;
+    array[2];
+  }
+  ASSERT_EQ(set_count, 1);
+  set_count = 0;
+
+  {
+    ArrayRead array;
+    array[0] = "hello";
+    array[1] += "world";
+  }
+  ASSERT_EQ(set_count, 1);
+  ArrayRead array;
+  ASSERT(array.get(1) == "world");
+}
+
 UNITTEST_MAIN() {
   RUN_TEST(array, batch)
   RUN_TEST(array, open)
   RUN_TEST(array, set);
   RUN_TEST(array, name);
+  RUN_TEST(array, read_only);
 }
\ No newline at end of file
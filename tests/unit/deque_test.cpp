@@ -0,0 +1,115 @@
+#include "platon/db/deque.hpp"
+#include "platon/name.hpp"
+#include "unit_test.hpp"
+
+typedef platon::db::Deque<"queue"_n, std::string> DequeStr;
+typedef platon::db::Deque<"int"_n, uint64_t> DequeInt;
+
+std::map<std::vector<uint8_t>, std::vector<uint8_t>> result;
+size_t set_count = 0;
+size_t get_count = 0;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void platon_set_state(const uint8_t *key, size_t klen, const uint8_t *value,
+                      size_t vlen) {
+  result[std::vector<uint8_t>(key, key + klen)] =
+      std::vector<uint8_t>(value, value + vlen);
+  set_count++;
+}
+
+size_t platon_get_state_length(const uint8_t *key, size_t klen) {
+  return result[std::vector<uint8_t>(key, key + klen)].size();
+}
+
+int32_t platon_get_state(const uint8_t *key, size_t klen, uint8_t *value,
+                         size_t vlen) {
+  get_count++;
+  const std::vector<uint8_t> &stored =
+      result[std::vector<uint8_t>(key, key + klen)];
+  if (stored.size() > vlen) {
+    return -1;
+  }
+  std::copy(stored.begin(), stored.end(), value);
+  return stored.size();
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+TEST_CASE(deque, push_pop) {
+  {
+    DequeStr queue;
+    ASSERT(queue.empty());
+    queue.push_back("b");
+    queue.push_front("a");
+    queue.push_back("c");
+  }
+
+  {
+    DequeStr queue;
+    ASSERT_EQ(queue.size(), 3);
+    ASSERT(queue.front() == "a");
+    ASSERT(queue.back() == "c");
+    ASSERT(queue.get(1) == "b");
+    queue.pop_front();
+    queue.pop_back();
+    queue[0] += "b";
+  }
+
+  DequeStr queue;
+  ASSERT_EQ(queue.size(), 1);
+  ASSERT(queue.front() == "bb");
+  queue.pop_back();
+  ASSERT(queue.empty());
+}
+
+TEST_CASE(deque, drain) {
+  {
+    DequeInt queue;
+    for (uint64_t i = 0; i < 100; i++) queue.push_back(i);
+  }
+
+  // each call processes a batch
+  uint64_t expect = 0;
+  for (int call = 0; call < 4; call++) {
+    DequeInt queue;
+    size_t n = queue.drain(30, [&](uint64_t value) {
+      ASSERT_EQ(value, expect++);
+    });
+    ASSERT_EQ(n, call < 3 ? 30 : 10);
+  }
+  ASSERT_EQ(expect, 100);
+
+  // the popped element is deleted
+  set_count = 0;
+  {
+    DequeInt queue;
+    ASSERT(queue.empty());
+    queue.push_back(7);
+    ASSERT_EQ(queue.drain(5, [](uint64_t) {}), 1);
+  }
+  ASSERT_EQ(set_count, 2);
+}
+
+TEST_CASE(deque, constant_cost) {
+  // an operation at either end reads the counters only
+  get_count = 0;
+  set_count = 0;
+  {
+    DequeInt queue;
+    queue.push_front(1);
+    queue.push_back(2);
+  }
+  ASSERT_EQ(get_count, 1);
+  ASSERT_EQ(set_count, 3);
+}
+
+UNITTEST_MAIN() {
+  RUN_TEST(deque, push_pop);
+  RUN_TEST(deque, drain);
+  RUN_TEST(deque, constant_cost);
+}
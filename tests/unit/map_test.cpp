@@ -6,6 +6,41 @@ typedef platon::db::Map<"str"_n, std::string, std::string> MapStr;
 
 typedef platon::db::Map<"insert"_n, std::string, std::string> MapInsert;
 
+typedef platon::db::Map<"read"_n, std::string, std::string> MapRead;
+
+std::map<std::vector<uint8_t>, std::vector<uint8_t>> result;
+size_t set_count = 0;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void platon_set_state(const uint8_t *key, size_t klen, const uint8_t *value,
+                      size_t vlen) {
+  result[std::vector<uint8_t>(key, key + klen)] =
+      std::vector<uint8_t>(value, value + vlen);
+  set_count++;
+}
+
+size_t platon_get_state_length(const uint8_t *key, size_t klen) {
+  return result[std::vector<uint8_t>(key, key + klen)].size();
+}
+
+int32_t platon_get_state(const uint8_t *key, size_t klen, uint8_t *value,
+                         size_t vlen) {
+  const std::vector<uint8_t> &stored =
+      result[std::vector<uint8_t>(key, key + klen)];
+  if (stored.size() > vlen) {
+    return -1;
+  }
+  std::copy(stored.begin(), stored.end(), value);
+  return stored.size();
+}
+
+#ifdef __cplusplus
+}
+#endif
+
 TEST_CASE(map, operator) {
   {
     MapStr map;
@@ -49,7 +84,68 @@ TEST_CASE(map, insert) {
   ASSERT(map["hello"] == "helloworld");
 }
 
+struct OldKey {
+  uint64_t name;
+  std::string key;
+  PLATON_SERIALIZE(OldKey, (name)(key))
+};
+
+TEST_CASE(map, key) {
+  std::string key = "hello";
+  platon::RLPStream old_stream;
+  old_stream << OldKey{"str"_n.value, key};
+  platon::RLPStream stream;
+  stream << MapStr::KeyWrapper(key);
+  ASSERT_EQ(stream.out().toBytes(), old_stream.out().toBytes());
+  ASSERT_EQ(platon::pack_size(MapStr::KeyWrapper(key)),
+            old_stream.out().size());
+}
+
+TEST_CASE(map, read_only) {
+  {
+    MapRead map;
+    map["a"] = "1";
+    map["b"] = "2";
+  }
+
+  // reads do not write anything back
+  set_count = 0;
+  {
+    MapRead map;
+    ASSERT(map["a"] == "1");
+    ASSERT(map.get("b") == "2");
+    ASSERT(map.get("missing").empty());
+    ASSERT(!map.contains("missing"));
+  }
+  ASSERT_EQ(set_count, 0);
+
+  // a missing key handed out mutably is created, even with the default value
+  {
+    MapRead map;
+    map["empty"] = "";
+    ASSERT(map.contains("empty"));
+  }
+  ASSERT_EQ(set_count, 1);
+  set_count = 0;
+
+  {
+    MapRead map;
+    map["a"] += "0";
+    map["b"] = "2";
+    map.erase("missing");
+    map.insert("c", "3");
+  }
+  ASSERT_EQ(set_count, 3);
+
+  MapRead map;
+  ASSERT(map.get("a") == "10");
+  ASSERT(map.contains("c"));
+  ASSERT(!map.contains("missing"));
+}
+
 UNITTEST_MAIN() {
   RUN_TEST(map, operator);
   RUN_TEST(map, insert);
+  RUN_TEST(map, key);
+  RUN_TEST(map, read_only);
 }
@@ -1,6 +1,8 @@
 
+#define PLATON_CONST_WRITE_CHECK
 #include "platon/db/multi_index.hpp"
 #include <map>
+#include <set>
 #include <platon/chain.hpp>
 #include <string>
 #include "platon/name.hpp"
@@ -11,6 +13,8 @@
 using namespace platon;
 using namespace platon::db;
 std::map<std::vector<byte>, std::vector<byte>> result;
+size_t get_count = 0;
+size_t set_count = 0;
 std::vector<byte> get_vector(const uint8_t *address, size_t len) {
   byte *ptr = (byte *)address;
   std::vector<byte> vect_result;
@@ -31,11 +35,13 @@ void platon_set_state(const uint8_t *key, size_t klen, const uint8_t *value,
   vect_key = get_vector(key, klen);
   vect_value = get_vector(value, vlen);
   result[vect_key] = vect_value;
+  set_count++;
 }
 
 size_t platon_get_state_length(const uint8_t *key, size_t klen) {
   std::vector<byte> vect_key;
   vect_key = get_vector(key, klen);
+  get_count++;
   return result[vect_key].size();
 }
 
@@ -43,11 +49,15 @@ int32_t platon_get_state(const uint8_t *key, size_t klen, uint8_t *value,
                          size_t vlen) {
   std::vector<byte> vect_key, vect_value;
   vect_key = get_vector(key, klen);
+  get_count++;
   vect_value = result[vect_key];
-  for (size_t i = 0; i < vlen && i < vect_value.size(); i++) {
+  if (vect_value.size() > vlen) {
+    return -1;
+  }
+  for (size_t i = 0; i < vect_value.size(); i++) {
     *(value + i) = vect_value[i];
   }
-  return vlen;
+  return vect_value.size();
 }
 
 #ifdef __cplusplus
@@ -64,6 +74,7 @@ struct Member {
   }
   std::string Name() const { return name; }
   uint8_t Age() const { return age; }
+  uint8_t Sex() const { return sex; }
   PLATON_SERIALIZE(Member, (name)(age)(sex))
 };
 
@@ -535,9 +546,643 @@ TEST_CASE(multi_index, effective) {
   platon_debug_gas(__LINE__, __func__, strlen(__func__));
 }
 
+typedef MultiIndex<
+    "churn"_n, Member,
+    IndexedBy<"index"_n, IndexMemberFun<Member, std::string, &Member::Name,
+                                        IndexType::UniqueIndex>>,
+    IndexedBy<"index2"_n, IndexMemberFun<Member, uint8_t, &Member::Age,
+                                         IndexType::NormalIndex>>>
+    ChurnTable;
+
+TEST_CASE(multi_index, churn) {
+  {
+    ChurnTable table;
+    for (int i = 0; i < 300; ++i) {
+      table.emplace([&](auto &m) {
+        m.name = "churn" + std::to_string(i);
+        m.age = uint8_t(i % 7);
+      });
+    }
+    int i = 0;
+    for (auto it = table.cbegin(); it != table.cend(); ++i) {
+      auto current = it++;
+      if (0 != i % 50) table.erase(current);
+    }
+  }
+
+  // iterating reads the live rows only
+  get_count = 0;
+  ChurnTable table;
+  std::vector<std::string> names;
+  for (auto it = table.cbegin(); it != table.cend(); ++it) {
+    names.push_back(it->name);
+  }
+  ASSERT_EQ(names.size(), 6);
+  ASSERT_EQ(names.front(), "churn0");
+  ASSERT_EQ(names.back(), "churn250");
+  ASSERT(get_count < 20, get_count);
+
+  auto it = table.cend();
+  --it;
+  ASSERT_EQ(it->name, "churn250");
+  --it;
+  ASSERT_EQ(it->name, "churn200");
+}
+
+TEST_CASE(multi_index, legacy_links) {
+  // rows written before the live rows were linked
+  for (uint64_t seq = 0; seq < 10; seq += 2) {
+    Member member{"legacy" + std::to_string(seq), uint8_t(seq), 0, 0};
+    set_state_db<"legacy"_n>(seq, member);
+  }
+  {
+    Uint64<"legacy"_n> seq;
+    seq = 10;
+  }
+
+  MultiIndex<"legacy"_n, Member,
+             IndexedBy<"index"_n, IndexMemberFun<Member, std::string,
+                                                 &Member::Name,
+                                                 IndexType::UniqueIndex>>>
+      table;
+  size_t count = 0;
+  for (auto it = table.cbegin(); it != table.cend(); ++it) {
+    ASSERT_EQ(it->age, count * 2);
+    count++;
+  }
+  ASSERT_EQ(count, 5);
+  table.emplace([&](auto &m) { m.name = "legacy10"; });
+  count = 0;
+  for (auto it = table.cbegin(); it != table.cend(); ++it) count++;
+  ASSERT_EQ(count, 6);
+}
+
+typedef MultiIndex<
+    "ordered"_n, Member,
+    IndexedBy<"index"_n, IndexMemberFun<Member, std::string, &Member::Name,
+                                        IndexType::UniqueIndex>>,
+    IndexedBy<"age"_n, IndexMemberFun<Member, uint8_t, &Member::Age,
+                                      IndexType::OrderedIndex<4>>>>
+    OrderedTable;
+
+TEST_CASE(multi_index, erase_iterating) {
+  MultiIndex<
+      "erasing"_n, Member,
+      IndexedBy<"index"_n, IndexMemberFun<Member, std::string, &Member::Name,
+                                          IndexType::UniqueIndex>>>
+      table;
+  for (int i = 0; i < 10; ++i) {
+    table.emplace([&](auto &m) {
+      m.name = "erase" + std::to_string(i);
+      m.age = uint8_t(i);
+    });
+  }
+
+  // an iterator of an erased row still moves to its neighbours
+  std::vector<std::string> names;
+  for (auto it = table.cbegin(); it != table.cend();) {
+    names.push_back(it->name);
+    auto current = it;
+    if (it->age % 3 != 0) table.erase(current);
+    ++it;
+  }
+  ASSERT_EQ(names.size(), 10);
+  ASSERT_EQ(names.back(), "erase9");
+
+  auto it = table.find<"index"_n>(std::string("erase6"));
+  auto current = it;
+  table.erase(current);
+  auto after = it;
+  ++after;
+  ASSERT_EQ(after->name, "erase9");
+  --it;
+  ASSERT_EQ(it->name, "erase3");
+  size_t count = 0;
+  for (it = table.cbegin(); it != table.cend(); ++it) count++;
+  ASSERT_EQ(count, 3);
+}
+
+TEST_CASE(multi_index, legacy_batches) {
+  // a legacy table longer than a batch
+  const uint64_t end_seq = kSeqLinkBatch * 3 + 10;
+  size_t live = 0;
+  for (uint64_t seq = 0; seq < end_seq; seq += 3) {
+    Member member{"batch" + std::to_string(seq), uint8_t(seq % 200), 0, 0};
+    set_state_db<"batches"_n>(seq, member);
+    live++;
+  }
+  {
+    Uint64<"batches"_n> seq;
+    seq = end_seq;
+  }
+  typedef MultiIndex<
+      "batches"_n, Member,
+      IndexedBy<"index"_n, IndexMemberFun<Member, std::string, &Member::Name,
+                                          IndexType::UniqueIndex>>>
+      BatchTable;
+
+  auto walk = [&](BatchTable &table) {
+    size_t forward = 0;
+    int previous = -1;
+    for (auto it = table.cbegin(); it != table.cend(); ++it) {
+      int current = std::stoi(it->name.substr(5));
+      ASSERT(current > previous, current, previous);
+      previous = current;
+      forward++;
+    }
+    size_t backward = 0;
+    for (auto it = table.cend(); it != table.cbegin();) {
+      --it;
+      backward++;
+    }
+    ASSERT_EQ(forward, backward);
+    return forward;
+  };
+
+  {
+    // the first object links one batch, the rest is probed
+    BatchTable table;
+    ASSERT_EQ(walk(table), live);
+    uint64_t cursor = 0;
+    ASSERT_EQ(get_state(SeqLinkCursorKey<"batches"_n>(), cursor), 2);
+    ASSERT_EQ(cursor, kSeqLinkBatch);
+
+    // changes on both sides of the cursor
+    // legacy rows have no index entries, they are found by iterating
+    for (auto it = table.cbegin(); it != table.cend();) {
+      auto current = it++;
+      if (current->name == "batch3" || current->name == "batch150") {
+        table.erase(current);
+      }
+    }
+    table.emplace([&](auto &m) { m.name = "batch" + std::to_string(end_seq); });
+    ASSERT_EQ(walk(table), live - 1);
+  }
+
+  size_t objects = 0;
+  while (has_state(SeqLinkCursorKey<"batches"_n>())) {
+    BatchTable table;
+    ASSERT_EQ(walk(table), live - 1);
+    objects++;
+  }
+  ASSERT_EQ(objects, 3);
+
+  // linked, iterating reads the live rows only
+  BatchTable table;
+  get_count = 0;
+  ASSERT_EQ(walk(table), live - 1);
+  ASSERT(get_count < 4 * live, get_count);
+}
+
+// runs last, the read only mode of the cache lasts until the end of the call
+TEST_CASE(multi_index, legacy_const) {
+  // a legacy table linked up to the cursor and one not linked at all
+  const uint64_t end_seq = kSeqLinkBatch * 2 + 10;
+  size_t live = 0;
+  for (uint64_t seq = 0; seq < end_seq; seq += 3) {
+    Member member{"query" + std::to_string(seq), 0, 0, 0};
+    set_state_db<"queried"_n>(seq, member);
+    set_state_db<"unlinked"_n>(seq, member);
+    live++;
+  }
+  {
+    Uint64<"queried"_n> queried;
+    queried = end_seq;
+    Uint64<"unlinked"_n> unlinked;
+    unlinked = end_seq;
+  }
+  typedef MultiIndex<
+      "queried"_n, Member,
+      IndexedBy<"index"_n, IndexMemberFun<Member, std::string, &Member::Name,
+                                          IndexType::UniqueIndex>>>
+      QueriedTable;
+  typedef MultiIndex<
+      "unlinked"_n, Member,
+      IndexedBy<"index"_n, IndexMemberFun<Member, std::string, &Member::Name,
+                                          IndexType::UniqueIndex>>>
+      UnlinkedTable;
+  {
+    QueriedTable table;
+    ASSERT(table.cbegin() != table.cend());
+  }
+  ASSERT(has_state(SeqLinkCursorKey<"queried"_n>()));
+
+  // a CONST action iterates both without writing, PLATON_CONST_WRITE_CHECK
+  // panics on a write
+  StateCache::instance().set_read_only();
+  set_count = 0;
+  QueriedTable queried;
+  UnlinkedTable unlinked;
+  size_t forward = 0;
+  for (auto it = queried.cbegin(); it != queried.cend(); ++it) forward++;
+  ASSERT_EQ(forward, live);
+  forward = 0;
+  for (auto it = unlinked.cbegin(); it != unlinked.cend(); ++it) forward++;
+  ASSERT_EQ(forward, live);
+  size_t backward = 0;
+  for (auto it = unlinked.cend(); it != unlinked.cbegin();) {
+    --it;
+    backward++;
+  }
+  ASSERT_EQ(backward, live);
+  ASSERT_EQ(set_count, 0);
+  uint64_t cursor = 0;
+  ASSERT_EQ(get_state(SeqLinkCursorKey<"queried"_n>(), cursor), 2);
+  ASSERT_EQ(cursor, kSeqLinkBatch);
+  ASSERT(!has_state(SeqLinkCursorKey<"unlinked"_n>()));
+}
+
+TEST_CASE(multi_index, ordered) {
+  {
+    // small nodes, so that leaves and internal nodes are split
+    OrderedTable table;
+    for (int i = 0; i < 200; ++i) {
+      table.emplace([&](auto &m) {
+        m.name = "ordered" + std::to_string(i);
+        m.age = uint8_t((i * 7) % 50);
+      });
+    }
+  }
+
+  OrderedTable table;
+  auto index = table.get_index<"age"_n>();
+  size_t count = 0;
+  uint8_t age = 0;
+  for (auto it = index.lower_bound(10); it != index.upper_bound(19); ++it) {
+    ASSERT(it->age >= age, it->age, age);
+    ASSERT_EQ(it.key(), it->age);
+    age = it->age;
+    count++;
+  }
+  ASSERT_EQ(count, 40);
+  ASSERT_EQ(age, 19);
+
+  auto range = index.equal_range(7);
+  count = 0;
+  for (auto it = range.first; it != range.second; ++it) {
+    ASSERT_EQ(it->age, 7);
+    count++;
+  }
+  ASSERT_EQ(count, 4);
+  ASSERT_EQ(table.count<"age"_n>(uint8_t(7)), 4);
+  ASSERT(index.lower_bound(50) == index.end());
+
+  // reverse order
+  count = 0;
+  age = 49;
+  for (auto it = index.end(); it != index.begin();) {
+    --it;
+    ASSERT(it->age <= age, it->age, age);
+    age = it->age;
+    count++;
+  }
+  ASSERT_EQ(count, 200);
+
+  // erasing through the index frees the emptied nodes
+  for (auto it = index.begin(); it != index.end() && it->age < 25;) {
+    auto current = it++;
+    index.erase(current);
+  }
+  {
+    OrderedTable reopened;
+    auto reindex = reopened.get_index<"age"_n>();
+    ASSERT_EQ(reindex.begin()->age, 25);
+    count = 0;
+    for (auto it = reindex.begin(); it != reindex.end(); ++it) count++;
+    ASSERT_EQ(count, 100);
+    for (auto it = reindex.begin(); it != reindex.end();) {
+      auto current = it++;
+      reopened.erase(reopened.find<"index"_n>(current->name));
+    }
+    ASSERT(reindex.begin() == reindex.end());
+    ASSERT_EQ(reopened.count<"age"_n>(uint8_t(30)), 0);
+  }
+}
+
+TEST_CASE(multi_index, modify_index) {
+  MultiIndex<
+      "modify"_n, Member,
+      IndexedBy<"index"_n, IndexMemberFun<Member, std::string, &Member::Name,
+                                          IndexType::UniqueIndex>>,
+      IndexedBy<"age"_n, IndexMemberFun<Member, uint8_t, &Member::Age,
+                                        IndexType::NormalIndex>>,
+      IndexedBy<"sex"_n, IndexMemberFun<Member, uint8_t, &Member::Sex,
+                                        IndexType::OrderedIndex<4>>>>
+      table;
+  for (int i = 0; i < 20; ++i) {
+    table.emplace([&](auto &m) {
+      m.name = "modify" + std::to_string(i);
+      m.age = uint8_t(i % 5);
+      m.sex = uint8_t(i % 2);
+    });
+  }
+  auto iter = table.find<"index"_n>(std::string("modify3"));
+
+  // no index key changed, only the row is written
+  set_count = 0;
+  ASSERT(table.modify(iter, [&](auto &m) { m.sex = 1; }));
+  ASSERT_EQ(set_count, 1);
+
+  // the normal index entry moves, the other indexes are untouched
+  set_count = 0;
+  ASSERT(table.modify(iter, [&](auto &m) { m.age = 30; }));
+  ASSERT(set_count <= 3, set_count);
+  ASSERT_EQ(table.count<"age"_n>(uint8_t(3)), 3);
+  ASSERT_EQ(table.count<"age"_n>(uint8_t(30)), 1);
+  auto index = table.get_index<"age"_n>();
+  ASSERT_EQ(index.cbegin(uint8_t(30))->name, "modify3");
+
+  // the ordered index entry moves
+  ASSERT(table.modify(iter, [&](auto &m) { m.sex = 7; }));
+  auto sex = table.get_index<"sex"_n>();
+  ASSERT_EQ(table.count<"sex"_n>(uint8_t(1)), 9);
+  ASSERT_EQ((--sex.end())->name, "modify3");
+
+  // the unique index entry moves
+  ASSERT(table.modify(iter, [&](auto &m) { m.name = "renamed"; }));
+  ASSERT(table.find<"index"_n>(std::string("modify3")) == table.cend());
+  iter = table.find<"index"_n>(std::string("renamed"));
+  ASSERT_EQ(iter->age, 30);
+
+  // the row keeps its sequence id, so its place in the table, and no row is
+  // added
+  auto it = table.cbegin();
+  for (int i = 0; i < 3; ++i) ++it;
+  ASSERT(it == iter);
+  size_t rows = 0;
+  for (it = table.cbegin(); it != table.cend(); ++it) rows++;
+  ASSERT_EQ(rows, 20);
+
+  // a taken unique key changes nothing
+  ASSERT(!table.modify(iter, [&](auto &m) {
+    m.name = "modify4";
+    m.age = 31;
+  }));
+  ASSERT_EQ(table.find<"index"_n>(std::string("renamed"))->age, 30);
+  ASSERT_EQ(table.count<"age"_n>(uint8_t(31)), 0);
+}
+
+TEST_CASE(multi_index, modify_normal) {
+  typedef MultiIndex<
+      "normal_mod"_n, Member,
+      IndexedBy<"index"_n, IndexMemberFun<Member, std::string, &Member::Name,
+                                          IndexType::UniqueIndex>>,
+      IndexedBy<"age"_n, IndexMemberFun<Member, uint8_t, &Member::Age,
+                                        IndexType::NormalIndex>>>
+      NormalTable;
+  NormalTable table;
+  const int rows = 200;
+  for (int i = 0; i < rows; ++i) {
+    table.emplace([&](auto &m) {
+      m.name = std::to_string(i);
+      m.age = uint8_t(i % 2);
+    });
+  }
+
+  // a row moved into an existing key can be erased again
+  auto one = table.find<"index"_n>(std::string("1"));
+  ASSERT(table.modify(one, [&](auto &m) { m.age = 0; }));
+  table.erase(table.find<"index"_n>(std::string("1")));
+  ASSERT_EQ(table.count<"age"_n>(uint8_t(0)), rows / 2);
+  auto index = table.get_index<"age"_n>();
+  size_t count = 0;
+  for (auto it = index.cbegin(uint8_t(0)); it != index.cend(uint8_t(0));
+       ++it) {
+    ASSERT(it->name != "1", it->name);
+    count++;
+  }
+  ASSERT_EQ(count, rows / 2);
+
+  // moving a row into a key with several full sections writes one section,
+  // the row and the section it left
+  auto three = table.find<"index"_n>(std::string("3"));
+  ASSERT(table.modify(three, [&](auto &m) { m.age = 0; }));
+  auto five = table.find<"index"_n>(std::string("5"));
+  set_count = 0;
+  ASSERT(table.modify(five, [&](auto &m) { m.age = 0; }));
+  ASSERT(set_count <= 3, set_count);
+
+  // rows moved into the middle of full sections are each listed once
+  for (int i = 7; i < rows; i += 2) {
+    auto row = table.find<"index"_n>(std::to_string(i));
+    ASSERT(table.modify(row, [&](auto &m) { m.age = 0; }));
+  }
+  ASSERT_EQ(table.count<"age"_n>(uint8_t(0)), rows - 1);
+  ASSERT_EQ(table.count<"age"_n>(uint8_t(1)), 0);
+  std::set<int> listed;
+  for (auto it = index.cbegin(uint8_t(0)); it != index.cend(uint8_t(0));
+       ++it) {
+    ASSERT(listed.insert(std::stoi(it->name)).second, it->name);
+  }
+  ASSERT_EQ(listed.size(), rows - 1);
+  for (int i = rows - 1; i >= 0; --i) {
+    if (1 == i) continue;
+    table.erase(table.find<"index"_n>(std::to_string(i)));
+    if (0 == i % 10) {
+      ASSERT_EQ(table.count<"age"_n>(uint8_t(0)), size_t(i - (i > 1)));
+    }
+  }
+  ASSERT_EQ(table.count<"age"_n>(uint8_t(0)), 0);
+}
+
+typedef MultiIndex<
+    "primary"_n, Member,
+    IndexedBy<"index"_n, IndexMemberFun<Member, std::string, &Member::Name,
+                                        IndexType::PrimaryIndex>>,
+    IndexedBy<"age"_n, IndexMemberFun<Member, uint8_t, &Member::Age,
+                                      IndexType::NormalIndex>>>
+    PrimaryTable;
+
+typedef MultiIndex<
+    "plain"_n, Member,
+    IndexedBy<"index"_n, IndexMemberFun<Member, std::string, &Member::Name,
+                                        IndexType::UniqueIndex>>,
+    IndexedBy<"age"_n, IndexMemberFun<Member, uint8_t, &Member::Age,
+                                      IndexType::NormalIndex>>>
+    PlainTable;
+
+TEST_CASE(multi_index, primary) {
+  {
+    PrimaryTable table;
+    PlainTable plain;
+    for (int i = 0; i < 10; ++i) {
+      auto r = table.emplace([&](auto &m) {
+        m.name = "primary" + std::to_string(i);
+        m.age = uint8_t(i % 3);
+      });
+      ASSERT(r.second);
+      plain.emplace([&](auto &m) {
+        m.name = "primary" + std::to_string(i);
+        m.age = uint8_t(i % 3);
+      });
+    }
+    ASSERT(!table.emplace([&](auto &m) { m.name = "primary3"; }).second);
+  }
+
+  // a point lookup is a single read
+  {
+    PrimaryTable table;
+    get_count = 0;
+    auto iter = table.find<"index"_n>(std::string("primary4"));
+    ASSERT_EQ(get_count, 1);
+    ASSERT_EQ(iter->age, 1);
+    ASSERT(table.find<"index"_n>(std::string("primary10")) == table.cend());
+  }
+
+  // secondary indexes and iteration reach the rows through the primary key,
+  // one read per row more than without a primary index
+  size_t plain_reads[2];
+  {
+    PlainTable plain;
+    auto index = plain.get_index<"age"_n>();
+    get_count = 0;
+    for (auto it = index.cbegin(uint8_t(2)); it != index.cend(uint8_t(2));
+         ++it) {
+      ASSERT_EQ(it->age, 2);
+    }
+    plain_reads[0] = get_count;
+    get_count = 0;
+    for (auto it = plain.cbegin(); it != plain.cend(); ++it) {
+      ASSERT(!it->name.empty());
+    }
+    plain_reads[1] = get_count;
+  }
+  PrimaryTable table;
+  auto index = table.get_index<"age"_n>();
+  size_t count = 0;
+  get_count = 0;
+  for (auto it = index.cbegin(uint8_t(2)); it != index.cend(uint8_t(2)); ++it) {
+    ASSERT_EQ(it->age, 2);
+    count++;
+  }
+  ASSERT_EQ(count, 3);
+  ASSERT_EQ(get_count, plain_reads[0] + 3);
+  count = 0;
+  get_count = 0;
+  for (auto it = table.cbegin(); it != table.cend(); ++it) {
+    ASSERT(!it->name.empty());
+    count++;
+  }
+  ASSERT_EQ(count, 10);
+  // the three rows of age 2 are cached already
+  ASSERT_EQ(get_count, plain_reads[1] + 7);
+
+  // changing the row rewrites it under the same key, the only copy
+  auto iter = table.find<"index"_n>(std::string("primary5"));
+  set_count = 0;
+  ASSERT(table.modify(iter, [&](auto &m) { m.sex = 1; }));
+  ASSERT_EQ(set_count, 1);
+
+  // changing the primary key moves the row
+  ASSERT(table.modify(iter, [&](auto &m) { m.name = "moved"; }));
+  ASSERT(!table.modify(iter, [&](auto &m) { m.name = "primary6"; }));
+  {
+    PrimaryTable reopened;
+    ASSERT(reopened.find<"index"_n>(std::string("primary5")) ==
+           reopened.cend());
+    auto moved = reopened.find<"index"_n>(std::string("moved"));
+    ASSERT_EQ(moved->sex, 1);
+    auto it = reopened.cbegin();
+    for (int i = 0; i < 5; ++i) ++it;
+    ASSERT(it == moved);
+    auto reindex = reopened.get_index<"age"_n>();
+    count = 0;
+    for (auto it = reindex.cbegin(uint8_t(2)); it != reindex.cend(uint8_t(2));
+         ++it) {
+      if (it->name == "moved") count++;
+    }
+    ASSERT_EQ(count, 1);
+    reopened.erase(moved);
+  }
+  PrimaryTable reopened;
+  ASSERT(reopened.find<"index"_n>(std::string("moved")) == reopened.cend());
+  ASSERT_EQ(reopened.count<"age"_n>(uint8_t(2)), 2);
+  ASSERT_EQ(reopened.count<"index"_n>(std::string("primary0")), 1);
+}
+
+struct Profile {
+  std::string name;
+  std::string nick;
+  std::string bio;
+  uint32_t level;
+  std::string Name() const { return name; }
+  std::string Nick() const { return nick; }
+  uint32_t Level() const { return level; }
+  PLATON_SERIALIZE(Profile, (name)(nick)(bio)(level))
+};
+
+typedef MultiIndex<
+    "profile"_n, Profile,
+    IndexedBy<"name"_n,
+              IndexMemberFun<Profile, std::string, &Profile::Name,
+                             IndexType::UniqueIndex>,
+              ProjectMemberFun<Profile, std::string, &Profile::Nick>,
+              ProjectMemberFun<Profile, uint32_t, &Profile::Level>>>
+    ProfileTable;
+
+TEST_CASE(multi_index, covering) {
+  {
+    ProfileTable table;
+    for (int i = 0; i < 5; ++i) {
+      table.emplace([&](auto &p) {
+        p.name = "user" + std::to_string(i);
+        p.nick = "nick" + std::to_string(i);
+        p.bio = std::string(200, 'a' + i);
+        p.level = i;
+      });
+    }
+  }
+
+  // the projection is read from the index entry alone
+  ProfileTable table;
+  auto index = table.get_index<"name"_n>();
+  get_count = 0;
+  auto r = index.project("user3");
+  ASSERT(r.second);
+  ASSERT_EQ(std::get<0>(r.first), "nick3");
+  ASSERT_EQ(std::get<1>(r.first), 3);
+  ASSERT_EQ(get_count, 1);
+  ASSERT(!index.project("user9").second);
+
+  auto iter = table.find<"name"_n>(std::string("user3"));
+  ASSERT_EQ(iter->bio, std::string(200, 'd'));
+
+  // a field that is not covered leaves the entry alone
+  set_count = 0;
+  ASSERT(table.modify(iter, [&](auto &p) { p.bio = "short"; }));
+  ASSERT_EQ(set_count, 1);
+
+  // a covered field rewrites the entry
+  set_count = 0;
+  ASSERT(table.modify(iter, [&](auto &p) { p.level = 30; }));
+  ASSERT_EQ(set_count, 2);
+  ASSERT_EQ(std::get<1>(index.project("user3").first), 30);
+
+  // the entry moves with the key
+  ASSERT(table.modify(iter, [&](auto &p) { p.name = "renamed"; }));
+  ASSERT(!index.project("user3").second);
+  r = index.project("renamed");
+  ASSERT(r.second);
+  ASSERT_EQ(std::get<0>(r.first), "nick3");
+
+  table.erase(table.find<"name"_n>(std::string("renamed")));
+  ASSERT(!index.project("renamed").second);
+  ASSERT(table.find<"name"_n>(std::string("user4")) != table.cend());
+}
+
 UNITTEST_MAIN() {
   RUN_TEST(multi_index, unique);
   RUN_TEST(multi_index, normal);
   RUN_TEST(multi_index, find);
   RUN_TEST(multi_index, effective);
+  RUN_TEST(multi_index, churn);
+  RUN_TEST(multi_index, legacy_links);
+  RUN_TEST(multi_index, erase_iterating);
+  RUN_TEST(multi_index, legacy_batches);
+  RUN_TEST(multi_index, ordered);
+  RUN_TEST(multi_index, modify_index);
+  RUN_TEST(multi_index, modify_normal);
+  RUN_TEST(multi_index, primary);
+  RUN_TEST(multi_index, covering);
+  RUN_TEST(multi_index, legacy_const);
 }
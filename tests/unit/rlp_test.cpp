@@ -116,6 +116,44 @@ class Derived : public Parent {
   std::string m_other_;
 };
 
+// writes a longer payload than its RLPSize operator announces
+class Unplanned {
+ public:
+  Unplanned() {}
+  explicit Unplanned(std::string data) : m_data_(data) {}
+  friend RLPStream& operator<<(RLPStream& rlp, const Unplanned& one) {
+    return rlp.appendList(1) << one.m_data_;
+  }
+
+  friend RLPSize& operator<<(RLPSize& rlps, const Unplanned& one) {
+    return rlps << RLPSize::list_start() << uint8_t(0) << RLPSize::list_end();
+  }
+
+  friend void fetch(RLP rlp, Unplanned& one) { fetch(rlp[0], one.m_data_); }
+
+ public:
+  std::string m_data_;
+};
+
+struct BoundedKey {
+  uint64_t table;
+  int16_t index;
+  bool flag;
+  PLATON_SERIALIZE(BoundedKey, (table)(index)(flag))
+};
+
+struct BoundedChild : public BoundedKey {
+  FixedHash<20> owner;
+  std::pair<uint8_t, int16_t> pair;
+  PLATON_SERIALIZE_DERIVED(BoundedChild, BoundedKey, (owner)(pair))
+};
+
+struct BorrowedRecord {
+  std::string_view name;
+  RLPView<uint64_t> values;
+  PLATON_SERIALIZE(BorrowedRecord, (name)(values))
+};
+
 TEST_CASE(rlp, int8_t) {
   const char* fn = "int8_t";
   int8_t int8_t_data = -2;
@@ -1049,6 +1087,308 @@ TEST_CASE(rlp, list_limit) {
   print_rlp_code("list_limit", "right", result);
 }
 
+TEST_CASE(rlp, planned) {
+  WhtType member(std::string(60, 'm'), 10, 20);
+  std::vector<Parent> parents;
+  std::map<std::string, Parent> named;
+  for (int i = 0; i < 5; i++) {
+    Parent one(std::string(i * 20, 'p'), i, member);
+    parents.push_back(one);
+    named[std::to_string(i)] = one;
+  }
+  auto data = std::make_tuple(parents, named, std::string("end"));
+
+  // same layout with plain containers, written list by list on close
+  using member_tuple = std::tuple<std::string, uint16_t, uint16_t>;
+  using parent_tuple = std::tuple<std::string, uint16_t, member_tuple>;
+  member_tuple member_data(member.m_name_, member.m_age_, member.m_weight_);
+  std::vector<parent_tuple> parents_data;
+  std::map<std::string, parent_tuple> named_data;
+  for (auto& one : parents) {
+    parent_tuple one_data(one.m_info_, one.m_number_, member_data);
+    parents_data.push_back(one_data);
+    named_data[std::to_string(one.m_number_)] = one_data;
+  }
+  RLPStream plain_stream;
+  plain_stream << std::make_tuple(parents_data, named_data, std::string("end"));
+
+  RLPStream stream;
+  stream.appendPlanned(data);
+  ASSERT(!stream.hasListPlan());
+  ASSERT_EQ(stream.out().toBytes(), plain_stream.out().toBytes());
+  ASSERT_EQ(stream.out().size(), pack_size(data));
+
+  stream.clear();
+  stream << parents[4];
+  RLPStream one_stream;
+  one_stream << parent_tuple(parents_data[4]);
+  ASSERT_EQ(stream.out().toBytes(), one_stream.out().toBytes());
+}
+
+TEST_CASE(rlp, planned_mismatch) {
+  std::vector<Unplanned> data = {Unplanned("short"),
+                                 Unplanned(std::string(100, 'u')),
+                                 Unplanned("tail")};
+  RLPStream stream;
+  stream.appendPlanned(std::make_tuple(data, data));
+  ASSERT(!stream.hasListPlan());
+
+  std::tuple<std::vector<Unplanned>, std::vector<Unplanned>> result;
+  fetch(RLP(stream.out()), result);
+  ASSERT_EQ(std::get<0>(result).size(), 3);
+  ASSERT_EQ(std::get<1>(result)[1].m_data_, std::string(100, 'u'));
+  ASSERT_EQ(std::get<1>(result)[2].m_data_, "tail");
+}
+
+TEST_CASE(rlp, max_pack_size) {
+  static_assert(max_pack_size<bool>() == 1);
+  static_assert(max_pack_size<int8_t>() == 2);
+  static_assert(max_pack_size<uint16_t>() == 3);
+  static_assert(max_pack_size<int64_t>() == 9);
+  static_assert(max_pack_size<bigint>() == 17);
+  static_assert(max_pack_size<FixedHash<20>>() == 21);
+  static_assert(max_pack_size<std::array<uint16_t, 30>>() == 92);
+  static_assert(max_pack_size<std::tuple<uint64_t, Name>>() == 20);
+  static_assert(max_pack_size<BoundedKey>() == 14);
+  static_assert(max_pack_size<BoundedChild>() == 42);
+  static_assert(max_pack_size<std::string>() == 0);
+  static_assert(max_pack_size<std::vector<uint8_t>>() == 0);
+  static_assert(max_pack_size<Parent>() == 0);
+  static_assert(max_pack_size<std::pair<uint8_t, std::string>>() == 0);
+
+  BoundedChild child;
+  child.table = UINT64_MAX;
+  child.index = INT16_MIN;
+  child.flag = true;
+  child.owner = FixedHash<20>("0x123456789abcdef0123456789abcdef012345678");
+  child.pair = std::make_pair(uint8_t(255), int16_t(-32768));
+  RLPStream stream;
+  stream << child;
+  ASSERT_EQ(stream.out().size(), max_pack_size<BoundedChild>());
+  ASSERT_EQ(pack_size(child), max_pack_size<BoundedChild>());
+
+  BoundedChild result;
+  fetch(RLP(stream.out()), result);
+  ASSERT_EQ(result.index, INT16_MIN);
+  ASSERT(result.owner == child.owner);
+  ASSERT_EQ(result.pair.second, -32768);
+}
+
+TEST_CASE(rlp, stack_buffer) {
+  byte buffer[8];
+  RLPStream small(buffer, sizeof(buffer));
+  small << std::make_tuple(uint64_t(1), uint64_t(2));
+  ASSERT_EQ(small.out().data(), buffer);
+
+  std::vector<std::string> data = {"hello", std::string(100, 'a')};
+  RLPStream spilled(buffer, sizeof(buffer));
+  spilled << data;
+  ASSERT_NE(spilled.out().data(), buffer);
+  RLPStream heap_stream;
+  heap_stream << data;
+  ASSERT_EQ(spilled.out().toBytes(), heap_stream.out().toBytes());
+
+  FixedHash<32> zero;
+  RLPStream zero_stream;
+  zero_stream << zero;
+  ASSERT_EQ(pack_size(zero), zero_stream.out().size());
+}
+
+TEST_CASE(rlp, views) {
+  static_assert(rlp_borrows_v<std::string_view>);
+  static_assert(rlp_borrows_v<std::vector<bytesConstRef>>);
+  static_assert(rlp_borrows_v<std::tuple<int, RLPView<std::string>>>);
+  static_assert(rlp_borrows_v<BorrowedRecord>);
+  static_assert(!rlp_borrows_v<std::string>);
+  static_assert(!rlp_borrows_v<Derived>);
+
+  std::string long_name(100, 'n');
+  RLPStream stream;
+  stream << std::make_tuple(long_name, bytes{1, 2, 3},
+                            std::vector<uint64_t>{1, 200, 30000});
+  bytesConstRef encoded = stream.out();
+
+  std::tuple<std::string_view, bytesConstRef, RLPView<uint64_t>> result;
+  fetch(RLP(encoded), result);
+  std::string_view name = std::get<0>(result);
+  ASSERT_EQ(name, long_name);
+  ASSERT((const byte *)name.data() > encoded.data());
+  ASSERT((const byte *)name.data() < encoded.data() + encoded.size());
+  ASSERT(std::get<1>(result).contentsEqual(bytes{1, 2, 3}));
+
+  RLPView<uint64_t> values = std::get<2>(result);
+  ASSERT_EQ(values.size(), 3);
+  ASSERT_EQ(values[1], 200);
+  uint64_t sum = 0;
+  for (uint64_t one : values) sum += one;
+  ASSERT_EQ(sum, 30201);
+
+  // forwarding views writes back the same encoding
+  RLPStream forward;
+  forward << result;
+  ASSERT_EQ(forward.out().toBytes(), encoded.toBytes());
+  ASSERT_EQ(pack_size(result), encoded.size());
+
+  BorrowedRecord record;
+  RLPStream record_stream;
+  record_stream << record;
+  BorrowedRecord empty;
+  fetch(RLP(record_stream.out()), empty);
+  ASSERT(empty.name.empty());
+  ASSERT(empty.values.empty());
+}
+
+TEST_CASE(rlp, index) {
+  std::vector<std::string> data;
+  for (int i = 0; i < 100; i++) data.push_back(std::string(i, 'i'));
+  RLPStream stream;
+  stream << data;
+  RLP list(stream.out());
+
+  ScopedArena scope;
+  RLPIndex index(list, scope.arena());
+  RLPIndex heap_index(list);
+  ASSERT_EQ(index.size(), 100);
+  ASSERT_EQ(heap_index.size(), 100);
+  for (size_t i = 100; i-- > 0;) {
+    ASSERT_EQ(index[i].toString(), data[i]);
+    ASSERT_EQ(heap_index[i].toString(), data[i]);
+  }
+  ASSERT(index[100].isNull());
+  ASSERT(RLPIndex(RLP(stream.out())[3]).empty());
+
+  std::vector<uint64_t> large(10000);
+  for (size_t i = 0; i < large.size(); i++) large[i] = i * i;
+  RLPStream large_stream;
+  large_stream << large;
+  std::vector<uint64_t> large_result;
+  fetch(RLP(large_stream.out()), large_result);
+  ASSERT_EQ(large_result, large);
+  ASSERT_EQ(large_result.capacity(), large.size());
+
+  std::map<std::string, uint32_t> map_data;
+  for (int i = 0; i < 50; i++) map_data[std::to_string(i)] = i;
+  RLPStream map_stream;
+  map_stream << map_data;
+  std::map<std::string, uint32_t> map_result;
+  fetch(RLP(map_stream.out()), map_result);
+  ASSERT_EQ(map_result, map_data);
+
+  std::array<std::string, 3> array_data = {"a", "bb", "ccc"};
+  RLPStream array_stream;
+  array_stream << array_data;
+  std::array<std::string, 3> array_result;
+  fetch(RLP(array_stream.out()), array_result);
+  ASSERT_EQ(array_result, array_data);
+}
+
+TEST_CASE(rlp, trusted) {
+  Derived derived("trusted", 300, WhtType("member", 7, 70),
+                  std::string(80, 'o'));
+  std::map<std::string, std::vector<Derived>> data = {
+      {"first", {derived, derived}}, {"second", {derived}}};
+  RLPStream stream;
+  stream << data;
+
+  std::map<std::string, std::vector<Derived>> strict_result;
+  fetch(RLP(stream.out()), strict_result);
+  std::map<std::string, std::vector<Derived>> trusted_result;
+  fetch(RLP(stream.out(), RLP::Trusted), trusted_result);
+  ASSERT(trusted_result == data);
+  ASSERT(trusted_result == strict_result);
+
+  // the canonical encoding is not checked on trusted data nor on its items
+  bytes long_form = {0xc2, 0x81, 0x05};
+  RLP trusted(long_form, RLP::Trusted);
+  ASSERT_EQ(trusted[0].toInt<uint8_t>(), 5);
+  std::vector<uint16_t> values;
+  fetch(trusted, values);
+  ASSERT_EQ(values.size(), 1);
+  ASSERT_EQ(values[0], 5);
+  ASSERT_EQ(uint8_t(*trusted.begin()), 5);
+}
+
+// encoding of the host functions, used to check the native integer path
+bytes host_int_encode(bigint value) {
+  uint64_t low = value;
+  uint64_t heigh = value >> 64;
+  bytes result(::rlp_u128_size(heigh, low));
+  ::platon_rlp_u128(heigh, low, result.data());
+  return result;
+}
+
+bytes host_bytes_encode(const bytes &value) {
+  bytes result(::rlp_bytes_size(value.data(), value.size()));
+  ::platon_rlp_bytes(value.data(), value.size(), result.data());
+  return result;
+}
+
+template <typename T>
+bool native_int_equal(T value, bigint host_value) {
+  RLPStream stream;
+  stream << value;
+  bytes result = stream.out().toBytes();
+  return result == host_int_encode(host_value) &&
+         result.size() == pack_size(value);
+}
+
+TEST_CASE(rlp, native_int) {
+  uint64_t value = 1;
+  for (int i = 0; i < 64; i++, value = (value << 1) | (i & 1)) {
+    ASSERT(native_int_equal(uint64_t(value), value), value);
+    ASSERT(native_int_equal(uint32_t(value), uint32_t(value)), value);
+    ASSERT(native_int_equal(uint16_t(value), uint16_t(value)), value);
+    ASSERT(native_int_equal(uint8_t(value), uint8_t(value)), value);
+    ASSERT(native_int_equal(bigint(value), value), value);
+
+    int64_t signed_value = int64_t(value);
+    int128_t wide = signed_value;
+    ASSERT(native_int_equal(signed_value,
+                            uint128_t((wide << 1) ^ (wide >> 127))));
+    ASSERT(native_int_equal(-signed_value,
+                            uint128_t((-wide << 1) ^ (-wide >> 127))));
+    int32_t small = int32_t(value);
+    wide = small;
+    ASSERT(native_int_equal(small, uint128_t((wide << 1) ^ (wide >> 127))));
+  }
+  ASSERT(native_int_equal(uint64_t(0), 0));
+  ASSERT(native_int_equal(int8_t(-128), 255));
+  ASSERT(native_int_equal(true, 1));
+  ASSERT(native_int_equal(false, 0));
+}
+
+TEST_CASE(rlp, native_bytes) {
+  bytes value;
+  for (size_t i = 0; i < 60; i++) {
+    RLPStream stream;
+    stream << value;
+    ASSERT_EQ(stream.out().toBytes(), host_bytes_encode(value), i);
+    value.push_back(byte(i * 7));
+  }
+  value = {0x7f};
+  RLPStream stream;
+  stream << value;
+  ASSERT_EQ(stream.out().toBytes(), host_bytes_encode(value));
+}
+
+TEST_CASE(rlp, scoped_stream) {
+  const byte *outer_data = nullptr;
+  {
+    ScopedStream outer;
+    *outer << std::string(100, 'o');
+    outer_data = outer->out().data();
+    ScopedStream inner(2);
+    *inner << 1 << 2;
+    ASSERT_NE(inner->out().data(), outer_data);
+  }
+
+  // the last released stream comes back empty with its buffer
+  ScopedStream again;
+  ASSERT_EQ(again->out().size(), 0);
+  *again << std::string(50, 'a');
+  ASSERT_EQ(again->out().data(), outer_data);
+}
+
 UNITTEST_MAIN() {
   RUN_TEST(rlp, int8_t);
   RUN_TEST(rlp, int8_t_reserve);
@@ -1098,4 +1438,14 @@ UNITTEST_MAIN() {
   RUN_TEST(rlp, bigint_limit);
   RUN_TEST(rlp, bytes_limit);
   RUN_TEST(rlp, list_limit);
+  RUN_TEST(rlp, native_int);
+  RUN_TEST(rlp, native_bytes);
+  RUN_TEST(rlp, planned);
+  RUN_TEST(rlp, planned_mismatch);
+  RUN_TEST(rlp, max_pack_size);
+  RUN_TEST(rlp, stack_buffer);
+  RUN_TEST(rlp, views);
+  RUN_TEST(rlp, index);
+  RUN_TEST(rlp, trusted);
+  RUN_TEST(rlp, scoped_stream);
 }
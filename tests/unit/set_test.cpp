@@ -0,0 +1,127 @@
+#include "platon/authority.hpp"
+#include "platon/db/set.hpp"
+#include "platon/name.hpp"
+#include "unit_test.hpp"
+
+using namespace platon;
+
+typedef db::Set<"str"_n, std::string> SetStr;
+
+std::map<std::vector<uint8_t>, std::vector<uint8_t>> result;
+size_t set_count = 0;
+size_t get_count = 0;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void platon_set_state(const uint8_t *key, size_t klen, const uint8_t *value,
+                      size_t vlen) {
+  result[std::vector<uint8_t>(key, key + klen)] =
+      std::vector<uint8_t>(value, value + vlen);
+  set_count++;
+}
+
+size_t platon_get_state_length(const uint8_t *key, size_t klen) {
+  get_count++;
+  return result[std::vector<uint8_t>(key, key + klen)].size();
+}
+
+int32_t platon_get_state(const uint8_t *key, size_t klen, uint8_t *value,
+                         size_t vlen) {
+  get_count++;
+  const std::vector<uint8_t> &stored =
+      result[std::vector<uint8_t>(key, key + klen)];
+  if (stored.size() > vlen) {
+    return -1;
+  }
+  std::copy(stored.begin(), stored.end(), value);
+  return stored.size();
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+TEST_CASE(set, member) {
+  {
+    SetStr set;
+    ASSERT(!set.contains("hello"));
+    set.insert("hello");
+    set.insert("world");
+    ASSERT(set.contains("hello"));
+  }
+
+  {
+    SetStr set;
+    ASSERT(set.contains("hello"));
+    ASSERT(set.contains("world"));
+    set.erase("world");
+    ASSERT(!set.contains("world"));
+  }
+
+  SetStr set;
+  ASSERT(set.contains("hello"));
+  ASSERT(!set.contains("world"));
+}
+
+TEST_CASE(set, cost) {
+  {
+    SetStr set;
+    for (int i = 0; i < 1000; i++) set.insert(std::to_string(i));
+  }
+
+  // one read per member, one write per changed member
+  get_count = 0;
+  set_count = 0;
+  {
+    SetStr set;
+    ASSERT(set.contains("500"));
+    ASSERT(set.contains("500"));
+    set.erase("1");
+    set.insert("2");
+    set.insert("new");
+    set.insert("500");
+  }
+  ASSERT_EQ(get_count, 4);
+  ASSERT_EQ(set_count, 2);
+}
+
+TEST_CASE(set, whitelist) {
+  Address first, second;
+  first[0] = 1;
+  second[0] = 2;
+  {
+    StorageType<"white"_n, std::set<Address>> old;
+    old.self() = {first, second};
+  }
+
+  {
+    WhiteList<"white"_n> whitelist;
+    ASSERT(whitelist.Exists(first));
+    ASSERT(whitelist.Exists(second));
+    ASSERT_EQ(whitelist.Migrate(), 0);
+    whitelist.Delete(first);
+    ASSERT(!whitelist.Exists(first));
+  }
+  ASSERT(!has_state(("white"_n).value));
+  WhiteList<"white"_n> whitelist;
+  ASSERT(!whitelist.Exists(first));
+  ASSERT(whitelist.Exists(second));
+
+  // an explicit migration moves the old set once
+  {
+    StorageType<"white2"_n, std::set<Address>> old;
+    old.self() = {first, second};
+  }
+  WhiteList<"white2"_n> explicit_list;
+  ASSERT_EQ(explicit_list.Migrate(), 2);
+  ASSERT_EQ(explicit_list.Migrate(), 0);
+  ASSERT(explicit_list.Exists(first));
+}
+
+UNITTEST_MAIN() {
+  RUN_TEST(set, member);
+  RUN_TEST(set, cost);
+  RUN_TEST(set, whitelist);
+}
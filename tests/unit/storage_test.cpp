@@ -6,6 +6,8 @@
 
 using namespace platon;
 std::map<std::vector<byte>, std::vector<byte>> result;
+size_t set_count = 0;
+size_t get_count = 0;
 
 std::vector<byte> get_vector(const uint8_t *address, size_t len) {
   byte *ptr = (byte *)address;
@@ -27,11 +29,13 @@ void platon_set_state(const uint8_t *key, size_t klen, const uint8_t *value,
   vect_key = get_vector(key, klen);
   vect_value = get_vector(value, vlen);
   result[vect_key] = vect_value;
+  set_count++;
 }
 
 size_t platon_get_state_length(const uint8_t *key, size_t klen) {
   std::vector<byte> vect_key;
   vect_key = get_vector(key, klen);
+  get_count++;
   return result[vect_key].size();
 }
 
@@ -39,11 +43,15 @@ int32_t platon_get_state(const uint8_t *key, size_t klen, uint8_t *value,
                          size_t vlen) {
   std::vector<byte> vect_key, vect_value;
   vect_key = get_vector(key, klen);
+  get_count++;
   vect_value = result[vect_key];
-  for (size_t i = 0; i < vlen && i < vect_value.size(); i++) {
+  if (vect_value.size() > vlen) {
+    return -1;
+  }
+  for (size_t i = 0; i < vect_value.size(); i++) {
     *(value + i) = vect_value[i];
   }
-  return vlen;
+  return vect_value.size();
 }
 
 #ifdef __cplusplus
@@ -102,4 +110,223 @@ TEST_CASE(storage, add) {
   }
 }
 
-UNITTEST_MAIN() { RUN_TEST(storage, add); }
\ No newline at end of file
+TEST_CASE(storage, dirty) {
+  set_count = 0;
+  {
+    StorageType<"count"_n, uint64_t> count;
+    StorageType<"names"_n, std::vector<std::string>> names;
+    count += 3;
+    names.self().push_back("first");
+  }
+  ASSERT_EQ(set_count, 2);
+
+  // reading, even through a mutable reference, writes nothing
+  set_count = 0;
+  {
+    StorageType<"count"_n, uint64_t> count;
+    StorageType<"names"_n, std::vector<std::string>> names;
+    StorageType<"untouched"_n, std::string> untouched;
+    ASSERT_EQ(count.get(), 3);
+    ASSERT_EQ(names.self().front(), "first");
+    ASSERT_EQ(names->size(), 1);
+  }
+  ASSERT_EQ(set_count, 0);
+
+  // a value changed through a reference is written back
+  {
+    StorageType<"names"_n, std::vector<std::string>> names;
+    names->push_back("second");
+    names.self().push_back("third");
+  }
+  ASSERT_EQ(set_count, 1);
+  {
+    const StorageType<"names"_n, std::vector<std::string>> names;
+    std::vector<std::string> right = {"first", "second", "third"};
+    ASSERT_EQ(*names, right);
+  }
+  ASSERT_EQ(set_count, 1);
+
+  // the stored bytes are compared, a value changed back is not written
+  {
+    StorageType<"names"_n, std::vector<std::string>> names;
+    names->push_back("fourth");
+    names->pop_back();
+  }
+  ASSERT_EQ(set_count, 1);
+}
+
+TEST_CASE(storage, lazy) {
+  get_count = 0;
+  set_count = 0;
+  {
+    StorageType<"lazy"_n, std::string> lazy("default");
+    StorageType<"unused"_n, std::map<std::string, std::string>> unused;
+    lazy = "assigned";
+  }
+  ASSERT_EQ(get_count, 0);
+  ASSERT_EQ(set_count, 1);
+
+  {
+    StorageType<"lazy"_n, std::string> lazy("default");
+    StorageType<"unused"_n, std::map<std::string, std::string>> unused;
+    ASSERT_EQ(get_count, 0);
+    ASSERT(lazy == std::string("assigned"));
+    ASSERT(!(lazy != std::string("assigned")));
+    ASSERT(lazy != std::string("other"));
+    ASSERT_EQ(lazy.get(), "assigned");
+    ASSERT_EQ(unused->size(), 0);
+  }
+  ASSERT_EQ(get_count, 2);
+  ASSERT_EQ(set_count, 1);
+}
+
+TEST_CASE(storage, speculative) {
+  set_state(std::string("small"), uint64_t(42));
+  set_state(std::string("large"), std::string(200, 'l'));
+
+  // a small value is read with one host call
+  get_count = 0;
+  uint64_t small = 0;
+  ASSERT_EQ(get_state(std::string("small"), small), 2);
+  ASSERT_EQ(small, 42);
+  ASSERT_EQ(get_count, 1);
+
+  // a longer one needs the length and a second read
+  get_count = 0;
+  std::string large;
+  get_state(std::string("large"), large);
+  ASSERT_EQ(large, std::string(200, 'l'));
+  ASSERT_EQ(get_count, 3);
+
+  get_count = 0;
+  ASSERT_EQ(get_state(std::string("absent"), small), 0);
+  ASSERT_EQ(get_count, 1);
+}
+
+struct StateKey {
+  uint64_t table;
+  uint64_t seq;
+  PLATON_SERIALIZE(StateKey, (table)(seq))
+};
+
+TEST_CASE(storage, bounded) {
+  StateKey key = {UINT64_MAX, 7};
+  std::pair<uint64_t, bool> value = {UINT64_MAX, true};
+  size_t capacity = Arena::transient().capacity();
+  set_state(key, value);
+  std::pair<uint64_t, bool> stored;
+  ASSERT_EQ(get_state(key, stored), 1 + pack_size(value));
+  ASSERT_EQ(stored, value);
+  ASSERT(has_state(key));
+  del_state(key);
+  ASSERT(!has_state(key));
+  ASSERT_EQ(Arena::transient().capacity(), capacity);
+
+  // data written by an older, wider version of the value is still read
+  set_state(key, std::string(100, 'c'));
+  std::string longer;
+  get_state(key, longer);
+  ASSERT_EQ(longer, std::string(100, 'c'));
+}
+
+TEST_CASE(storage, borrowed) {
+  std::string value(300, 'v');
+  set_state(std::string("borrowed"), value);
+  std::string_view view;
+  get_state(std::string("borrowed"), view);
+
+  // later state accesses reuse the transient arena
+  for (int i = 0; i < 10; i++) {
+    set_state(i, std::string(500, 'x'));
+    std::string other;
+    get_state(i, other);
+  }
+  ASSERT_EQ(view, value);
+}
+
+TEST_CASE(storage, pooled) {
+  std::vector<std::string> value = {"pooled", std::string(300, 'p')};
+  set_state(std::string("pooled"), value);
+  const byte *data = nullptr;
+  {
+    ScopedStream stream;
+    data = stream->out().data();
+  }
+  for (int i = 0; i < 1000; i++) {
+    set_state(std::string("pooled"), value);
+    ScopedStream stream;
+    ASSERT_EQ(stream->out().data(), data);
+  }
+}
+
+TEST_CASE(storage, cache) {
+  StateCache &cache = StateCache::instance();
+  cache.enable();
+  get_count = 0;
+  set_count = 0;
+
+  // each key is read once
+  set_state(std::string("fresh"), 0);
+  cache.flush();
+  ASSERT(has_state(std::string("fresh")));
+  int value = -1;
+  get_state(std::string("fresh"), value);
+  ASSERT_EQ(value, 0);
+  ASSERT(!has_state(std::string("missing")));
+  ASSERT(!has_state(std::string("missing")));
+  ASSERT_EQ(get_count, 2);
+
+  // writes to a key are combined
+  set_count = 0;
+  for (int i = 1; i <= 10; i++) set_state(std::string("fresh"), i);
+  get_state(std::string("fresh"), value);
+  ASSERT_EQ(value, 10);
+  del_state(std::string("missing"));
+  ASSERT_EQ(set_count, 0);
+  cache.flush();
+  ASSERT_EQ(set_count, 2);
+
+  // a flushed cache reads the chain again
+  get_count = 0;
+  value = -1;
+  get_state(std::string("fresh"), value);
+  ASSERT_EQ(value, 10);
+  ASSERT_EQ(get_count, 1);
+}
+
+class QueryContract {
+ public:
+  void Touch(const std::string &message) const {
+    info.self().push_back(message);
+    set_state(std::string("query"), message);
+  }
+
+ private:
+  mutable StorageType<"info"_n, std::vector<std::string>> info;
+};
+
+TEST_CASE(storage, const_action) {
+  StateCache &cache = StateCache::instance();
+  cache.flush();
+  set_count = 0;
+  RLPStream input(2);
+  input << uint64_t(1) << std::string("query");
+  RLP rlp(input.out());
+  execute_action(rlp, &QueryContract::Touch);
+  cache.flush();
+  ASSERT(cache.read_only());
+  ASSERT_EQ(set_count, 0);
+  ASSERT(!has_state(std::string("query")));
+}
+
+UNITTEST_MAIN() {
+  RUN_TEST(storage, add);
+  RUN_TEST(storage, dirty);
+  RUN_TEST(storage, lazy);
+  RUN_TEST(storage, speculative);
+  RUN_TEST(storage, bounded);
+  RUN_TEST(storage, borrowed);
+  RUN_TEST(storage, pooled);
+  RUN_TEST(storage, cache);
+  RUN_TEST(storage, const_action);
+}
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "platon/db/vector.hpp"
+#include "platon/name.hpp"
+#include "unit_test.hpp"
+
+typedef platon::db::Vector<"log"_n, std::string> VectorLog;
+typedef platon::db::Vector<"int"_n, uint64_t> VectorInt;
+
+std::map<std::vector<uint8_t>, std::vector<uint8_t>> result;
+size_t set_count = 0;
+size_t get_count = 0;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void platon_set_state(const uint8_t *key, size_t klen, const uint8_t *value,
+                      size_t vlen) {
+  result[std::vector<uint8_t>(key, key + klen)] =
+      std::vector<uint8_t>(value, value + vlen);
+  set_count++;
+}
+
+size_t platon_get_state_length(const uint8_t *key, size_t klen) {
+  return result[std::vector<uint8_t>(key, key + klen)].size();
+}
+
+int32_t platon_get_state(const uint8_t *key, size_t klen, uint8_t *value,
+                         size_t vlen) {
+  get_count++;
+  const std::vector<uint8_t> &stored =
+      result[std::vector<uint8_t>(key, key + klen)];
+  if (stored.size() > vlen) {
+    return -1;
+  }
+  std::copy(stored.begin(), stored.end(), value);
+  return stored.size();
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+TEST_CASE(vector, push_pop) {
+  {
+    VectorLog log;
+    ASSERT(log.empty());
+    log.push_back("hello");
+    log.push_back("world");
+    ASSERT_EQ(log.size(), 2);
+    ASSERT(log.back() == "world");
+  }
+
+  {
+    VectorLog log;
+    ASSERT_EQ(log.size(), 2);
+    ASSERT(log[0] == "hello");
+    log.pop_back();
+    log.push_back("again");
+    log.pop_back();
+    ASSERT_EQ(log.size(), 1);
+  }
+
+  VectorLog log;
+  ASSERT_EQ(log.size(), 1);
+  ASSERT(log.get(0) == "hello");
+  log[0] += " world";
+}
+
+TEST_CASE(vector, constant_cost) {
+  for (uint64_t i = 0; i < 100; i++) {
+    VectorInt vector;
+    vector.push_back(i);
+  }
+
+  // an append reads the length and writes the element and the length
+  get_count = 0;
+  set_count = 0;
+  {
+    VectorInt vector;
+    vector.push_back(100);
+  }
+  ASSERT_EQ(get_count, 1);
+  ASSERT_EQ(set_count, 2);
+
+  // a read loads one element and writes nothing
+  get_count = 0;
+  set_count = 0;
+  {
+    VectorInt vector;
+    ASSERT_EQ(vector[50], 50);
+    ASSERT_EQ(vector.get(99), 99);
+  }
+  ASSERT_EQ(get_count, 3);
+  ASSERT_EQ(set_count, 0);
+}
+
+TEST_CASE(vector, iterate) {
+  VectorInt vector;
+  uint64_t sum = 0;
+  size_t next = 0;
+  while (next < vector.size()) {
+    next = vector.for_each(next, 30, [&](size_t pos, uint64_t value) {
+      ASSERT_EQ(pos, value);
+      sum += value;
+    });
+  }
+  ASSERT_EQ(sum, 5050);
+  ASSERT_EQ(vector.for_each(next, 30, [](size_t, uint64_t) {}), next);
+
+  uint64_t expect = 0;
+  for (auto iter = vector.begin(); iter != vector.end(); ++iter) {
+    ASSERT_EQ(*iter, expect++);
+  }
+  ASSERT_EQ(expect, 101);
+}
+
+UNITTEST_MAIN() {
+  RUN_TEST(vector, push_pop);
+  RUN_TEST(vector, constant_cost);
+  RUN_TEST(vector, iterate);
+}
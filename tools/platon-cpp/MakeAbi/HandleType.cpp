@@ -225,12 +225,32 @@ StringRef MakeAbi::handleType(DINode* Node, DIType* DT){
   }
 }
 
+// member function whose this pointer points to a const object
+bool isConstMember(DISubroutineType* ST){
+  DITypeRefArray TRA = ST->getTypeArray();
+  if(TRA->getNumOperands() < 2)
+    return false;
+
+  if(DIDerivedType* This = dyn_cast_or_null<DIDerivedType>(TRA->getOperand(1).get()))
+    if(This->getTag() == dwarf::DW_TAG_pointer_type)
+      if(DIDerivedType* Obj = dyn_cast_or_null<DIDerivedType>(This->getBaseType()))
+        return Obj->getTag() == dwarf::DW_TAG_const_type;
+
+  return false;
+}
+
 json::Value MakeAbi::handleAction(DISubprogram* SP, json::Value Params, bool isConst){
   
   DISubroutineType* ST = cast<DISubroutineType>(SP->getType());
   DITypeRefArray TRA = ST->getTypeArray();
   Metadata* RetType = TRA->getOperand(0).get();
 
+  // the dispatcher runs const member functions read only
+  if(isConst && !isConstMember(ST))
+    report_fatal_error("Const function must be const member function");
+  if(!isConst && isConstMember(ST))
+    report_fatal_error("const member function must be declared CONST");
+
   json::Value Ret = 
     RetType? 
     handleType(SP, cast<DIType>(RetType)):
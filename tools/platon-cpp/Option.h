@@ -9,6 +9,7 @@ public:
   bool NoABI;
   bool Help;
   bool OutputIR;
+  std::string Allocator;
   std::vector<std::string> ldArgs;
   std::vector<std::string> clangUserArgs;
   std::vector<std::string> clangArgs;
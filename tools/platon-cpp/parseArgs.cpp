@@ -24,11 +24,28 @@ bool PCCOption::ParseArgs(int argc, char** argv) {
   llvm::sys::path::remove_filename(bindir0);
   bindir = bindir0.c_str();
 
+  // --allocator is a platon-cpp option, keep it away from the clang parser
+  Allocator = "freelist";
+  vector<const char*> argList;
+  for(int i=1; i<argc; i++) {
+    StringRef arg(argv[i]);
+    if(arg.startswith("--allocator="))
+      Allocator = arg.substr(strlen("--allocator=")).str();
+    else
+      argList.push_back(argv[i]);
+  }
+
+  if(Allocator != "freelist" && Allocator != "bump" && Allocator != "arena"){
+    llvm::outs() << "error: unknown allocator '" << Allocator
+                 << "', expected freelist, bump or arena\n";
+    return false;
+  }
+
   unsigned MissingArgIndex, MissingArgCount;
   const OptTable &clangOpts = clang::driver::getDriverOptTable();
 
   InputArgList Args = clangOpts.ParseArgs(
-    makeArrayRef(argv + 1, argc - 1),
+    makeArrayRef(argList),
     MissingArgIndex, MissingArgCount);
 
   Help = false;
@@ -74,6 +91,9 @@ bool PCCOption::ParseArgs(int argc, char** argv) {
         llvm::outs(), "platon-cpp [clang args]",
         "PlatON C++ WASM Compiler",
         0, 0, false);
+    llvm::outs() << "\nPLATON OPTIONS:\n"
+                 << "  --allocator=<value>     Select the malloc implementation "
+                    "linked into the contract: freelist (default), bump, arena\n";
     return false;
   }
 
@@ -135,7 +155,11 @@ void PCCOption::AdjustLLDArgs(bool NoStdlib){
     ldArgs.push_back("-L");
     ldArgs.push_back(libdir);
 
-    ldArgs.push_back("-lmalloc");
+    // freelist is the default libmalloc, the others have their own archive
+    if(Allocator == "freelist")
+      ldArgs.push_back("-lmalloc");
+    else
+      ldArgs.push_back("-lmalloc_" + Allocator);
     ldArgs.push_back("-lc");
     ldArgs.push_back("-lc++");
     ldArgs.push_back("-lbuiltins");
@@ -19,6 +19,7 @@ StringRef getName(DINode* Node);
 bool isString(DICompositeType* DerT);
 bool isVector(DICompositeType* CT);
 bool isFixedHash(DICompositeType* CT);
+bool isConstMember(DISubroutineType* ST);
 
 TEST(ABITest, StringTest) {
   LLVMContext Ctx;
@@ -214,6 +215,37 @@ TEST(ABITest, handleStructTypeTest) {
   EXPECT_EQ(result, v);
 }
 
+TEST(ABITest, isConstMemberTest) {
+  LLVMContext Ctx;
+  StringRef Source = R"(
+    !0 = distinct !DICompositeType(tag: DW_TAG_class_type, name: "C", size: 8, identifier: "_ZTS1C")
+    !1 = !DIDerivedType(tag: DW_TAG_const_type, baseType: !0)
+    !2 = !DIDerivedType(tag: DW_TAG_pointer_type, baseType: !1, size: 32, flags: DIFlagArtificial | DIFlagObjectPointer)
+    !3 = !DIDerivedType(tag: DW_TAG_pointer_type, baseType: !0, size: 32, flags: DIFlagArtificial | DIFlagObjectPointer)
+    !4 = !DIBasicType(name: "int", size: 32, encoding: DW_ATE_signed)
+    !5 = !DISubroutineType(types: !6)
+    !6 = !{!4, !2}
+    !7 = !DISubroutineType(types: !8)
+    !8 = !{null, !3, !4}
+    !9 = !DISubroutineType(types: !10)
+    !10 = !{!4}
+    )";
+
+  SMDiagnostic Error;
+  SlotMapping Mapping;
+  auto Mod = parseAssemblyString(Source, Error, Ctx, &Mapping);
+
+  EXPECT_TRUE(Error.getMessage().empty());
+
+  DISubroutineType* constMember = cast<DISubroutineType>(Mapping.MetadataNodes[5].get());
+  DISubroutineType* member = cast<DISubroutineType>(Mapping.MetadataNodes[7].get());
+  DISubroutineType* function = cast<DISubroutineType>(Mapping.MetadataNodes[9].get());
+
+  EXPECT_TRUE(isConstMember(constMember));
+  EXPECT_TRUE(!isConstMember(member));
+  EXPECT_TRUE(!isConstMember(function));
+}
+
 UNITTEST_MAIN() {
   RUN_TEST(ABITest, StringTest);
   RUN_TEST(ABITest, VectorTest);
@@ -222,6 +254,7 @@ UNITTEST_MAIN() {
   RUN_TEST(ABITest, BasicTypeTest);
   RUN_TEST(ABITest, handleElemTest);
   RUN_TEST(ABITest, handleDerivedTypeTest);
+  RUN_TEST(ABITest, isConstMemberTest);
   //RUN_TEST(ABITest, handleStructTypeTest);
 }
 
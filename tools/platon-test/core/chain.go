@@ -24,6 +24,9 @@ type MockStateDB struct {
 	TxIndex      int
 	logSize      uint
 	Logs         map[common.Hash][]*types.Log
+
+	// host state accesses, the length query counts as a read
+	Reads, Writes uint64
 }
 
 func NewMockStateDB() *MockStateDB {
@@ -77,10 +80,12 @@ func (s *MockStateDB) GetBalance(adr common.Address) *big.Int {
 }
 
 func (s *MockStateDB) GetState(adr common.Address, key []byte) []byte {
+	s.Reads++
 	return s.State[adr][string(key)]
 }
 
 func (s *MockStateDB) SetState(adr common.Address, key, val []byte) {
+	s.Writes++
 	if len(val) == 0 {
 		delete(s.State[adr], string(key))
 	} else {
@@ -167,7 +167,8 @@ func ExecFile(filePath string) error {
 	rtrns, err := vm.ExecCode(index)
 
 	// gas result
-	fmt.Fprintf(os.Stdin, "gas cost:%d, opcodes:%d\n", initGas - contractCtx.Gas, opCodes)
+	fmt.Fprintf(os.Stdout, "gas cost:%d, opcodes:%d\n", initGas - contractCtx.Gas, opCodes)
+	fmt.Fprintf(os.Stdout, "state reads:%d, state writes:%d\n", db.Reads, db.Writes)
 	if err != nil {
 		fmt.Fprintf(os.Stderr, "execute code failed!!! err=%v\n", err)
 		return err